@@ -2,6 +2,9 @@
 
 ConstantBuffer<Constants> Globals : register(b0);
 
+// Patches that survived CPU culling, Globals.NumPatches of them
+StructuredBuffer<uint> VisiblePatches : register(t1);
+
 [RootSignature(ROOT_SIG)]
 [NumThreads(AS_GROUP_SIZE, 1, 1)]
 void main(uint dtid : SV_DispatchThreadID, uint gtid : SV_GroupThreadID, uint gid : SV_GroupID)
@@ -19,7 +22,7 @@ void main(uint dtid : SV_DispatchThreadID, uint gtid : SV_GroupThreadID, uint gi
             const uint numTrisProcessed = relGroupIdx * MAX_TRIANGLES_PER_GROUP;
             const uint groupID = patchIdx * numGroupsPerPatch + relGroupIdx;
             
-            payload.Patch[groupID] = patchIdx;
+            payload.Patch[groupID] = VisiblePatches[patchIdx];
             payload.StartingTriIndices[groupID] = numTrisProcessed;
             payload.NumPrimitives[groupID] = min(Globals.NumTrianglesPerPatch - numTrisProcessed, MAX_TRIANGLES_PER_GROUP);
         }
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
+
+#include "BezierMaths.h"
+#include "BezierTessellation.h"
+
+namespace BezierMaths
+{
+    struct AdaptiveTessellationOptions
+    {
+        // Largest distance allowed between the surface and a triangle edge or centre, in the patch's units
+        float Tolerance = 1e-3f;
+
+        // Edges shorter than this in the (u, w) domain are never split
+        float MinEdgeLength = 1.f / 256.f;
+
+        // Backstop for surfaces the tolerance can't be met on, edges always stop splitting at MinEdgeLength well before this
+        // Triangles at this depth still split the edges that need it but don't subdivide the pieces any further
+        unsigned MaxDepth = 32;
+    };
+
+    // Splits a patch where it bends and leaves it coarse where it is flat
+    // Whether an edge is split only depends on the edge itself: the surface has to stray more than Tolerance from the straight line between
+    // its ends at a quarter, half or three quarters of the way along. Both triangles on an edge make the same call, so every split edge is
+    // split on both sides and there are no T-junctions. A triangle splits 1-to-2, 1-to-3 or 1-to-4 depending on how many of its edges split,
+    // and 1-to-3 at its centre when no edge splits but the centre still strays. Triangles keep the row grid's winding
+    // At MaxDepth a triangle still splits its edges but emits the pieces without testing them, so lowering it can't open cracks either
+    template<unsigned N>
+    IndexedMesh<uint32_t> TessellatePatchAdaptive(BezierTriangle<N> const& patch, AdaptiveTessellationOptions const& options = {})
+    {
+        using namespace DirectX::SimpleMath;
+
+        // Domain points are (u, w), v is 1 - u - w
+        struct DomainPoint
+        {
+            float u, w;
+        };
+
+        auto const midpoint = [](DomainPoint const& a, DomainPoint const& b, float t) -> DomainPoint
+        {
+            return { a.u * (1 - t) + b.u * t, a.w * (1 - t) + b.w * t };
+        };
+
+        auto const position = [&patch](DomainPoint const& point)
+        {
+            return Evaluate(patch, { point.u, 1.f - point.u - point.w, point.w }).position;
+        };
+
+        IndexedMesh<uint32_t> result;
+
+        // Vertices are shared by the exact bits of their domain point, a split edge's midpoint comes out the same from either side
+        std::unordered_map<uint64_t, uint32_t> vertexIndices;
+        auto const vertex = [&](DomainPoint const& point)
+        {
+            uint32_t u, w;
+            std::memcpy(&u, &point.u, sizeof(u));
+            std::memcpy(&w, &point.w, sizeof(w));
+
+            auto const inserted = vertexIndices.try_emplace((uint64_t(u) << 32) | w, static_cast<uint32_t>(result.Vertices.size()));
+            if (inserted.second)
+            {
+                result.Vertices.push_back(Evaluate(patch, { point.u, 1.f - point.u - point.w, point.w }));
+            }
+
+            return inserted.first->second;
+        };
+
+        float const toleranceSquared = options.Tolerance * options.Tolerance;
+        float const minEdgeLengthSquared = options.MinEdgeLength * options.MinEdgeLength;
+
+        auto const splitEdge = [&](DomainPoint a, DomainPoint b)
+        {
+            float const du = b.u - a.u, dw = b.w - a.w;
+            if (du * du + dw * dw <= minEdgeLengthSquared)
+            {
+                return false;
+            }
+
+            // Same end first whichever triangle asks
+            if (b.u < a.u || (b.u == a.u && b.w < a.w))
+            {
+                std::swap(a, b);
+            }
+
+            Vector3 const start = position(a), end = position(b);
+            for (float t : { 0.25f, 0.5f, 0.75f })
+            {
+                if ((position(midpoint(a, b, t)) - (start * (1 - t) + end * t)).LengthSquared() > toleranceSquared)
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        };
+
+        auto const emit = [&](DomainPoint const& a, DomainPoint const& b, DomainPoint const& c)
+        {
+            result.Indices.push_back(vertex(a));
+            result.Indices.push_back(vertex(b));
+            result.Indices.push_back(vertex(c));
+        };
+
+        auto const subdivide = [&](auto const& self, DomainPoint const (&corners)[3], unsigned depth) -> void
+        {
+            // Edge e runs from corner e to corner e + 1
+            bool split[3];
+            DomainPoint middle[3];
+            unsigned numSplit = 0;
+            for (unsigned edge = 0; edge < 3; ++edge)
+            {
+                split[edge] = splitEdge(corners[edge], corners[(edge + 1) % 3]);
+                middle[edge] = midpoint(corners[edge], corners[(edge + 1) % 3], 0.5f);
+                numSplit += split[edge] ? 1 : 0;
+            }
+
+            // At the depth limit the pieces are emitted without being tested any further
+            bool const atLimit = depth >= options.MaxDepth;
+            auto const recurse = [&](DomainPoint const& a, DomainPoint const& b, DomainPoint const& c)
+            {
+                if (atLimit)
+                {
+                    emit(a, b, c);
+                    return;
+                }
+
+                DomainPoint const child[3] = { a, b, c };
+                self(self, child, depth + 1);
+            };
+
+            if (numSplit == 0)
+            {
+                float const area = std::fabs((corners[1].u - corners[0].u) * (corners[2].w - corners[0].w) - (corners[2].u - corners[0].u) * (corners[1].w - corners[0].w)) * 0.5f;
+                DomainPoint const centre = { (corners[0].u + corners[1].u + corners[2].u) / 3.f, (corners[0].w + corners[1].w + corners[2].w) / 3.f };
+                Vector3 const flatCentre = (position(corners[0]) + position(corners[1]) + position(corners[2])) / 3.f;
+
+                if (!atLimit && area * 2.f > minEdgeLengthSquared && (position(centre) - flatCentre).LengthSquared() > toleranceSquared)
+                {
+                    recurse(corners[0], corners[1], centre);
+                    recurse(corners[1], corners[2], centre);
+                    recurse(corners[2], corners[0], centre);
+                }
+                else
+                {
+                    emit(corners[0], corners[1], corners[2]);
+                }
+
+                return;
+            }
+
+            if (numSplit == 3)
+            {
+                recurse(corners[0], middle[0], middle[2]);
+                recurse(middle[0], corners[1], middle[1]);
+                recurse(middle[2], middle[1], corners[2]);
+                recurse(middle[0], middle[1], middle[2]);
+                return;
+            }
+
+            // Rotate so edge 0 is the split edge when one splits and the unsplit edge is 2 when two split
+            unsigned first = 0;
+            while (numSplit == 1 ? !split[first] : split[(first + 2) % 3])
+            {
+                ++first;
+            }
+
+            DomainPoint const& p0 = corners[first];
+            DomainPoint const& p1 = corners[(first + 1) % 3];
+            DomainPoint const& p2 = corners[(first + 2) % 3];
+            DomainPoint const& m0 = middle[first];
+
+            if (numSplit == 1)
+            {
+                recurse(p0, m0, p2);
+                recurse(m0, p1, p2);
+            }
+            else
+            {
+                DomainPoint const& m1 = middle[(first + 1) % 3];
+                recurse(m0, p1, m1);
+                recurse(p0, m0, m1);
+                recurse(p0, m1, p2);
+            }
+        };
+
+        // j, k, i is clockwise in (u, w) like the row grid
+        DomainPoint const root[3] = { { 0.f, 0.f }, { 0.f, 1.f }, { 1.f, 0.f } };
+        subdivide(subdivide, root, 0);
+
+        return result;
+    }
+}
\ No newline at end of file
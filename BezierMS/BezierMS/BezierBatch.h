@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cassert>
+#include <algorithm>
+
+#include "BezierMaths.h"
+#include "BezierSimd.h"
+
+namespace BezierMaths
+{
+    // Barycentric samples in structure of arrays layout, U weights the i corner, V the j corner and W the k corner like uvw.x/y/z in Evaluate
+    struct BarycentricSamples
+    {
+        Span<float const> U;
+        Span<float const> V;
+        Span<float const> W;
+
+        size_t Count() const { return U.Size; }
+    };
+
+    // Evaluated vertices in structure of arrays layout
+    struct VertexStreams
+    {
+        Span<float> PositionX;
+        Span<float> PositionY;
+        Span<float> PositionZ;
+        Span<float> NormalX;
+        Span<float> NormalY;
+        Span<float> NormalZ;
+    };
+
+    // De Casteljau over registers of patches or samples, points holds the control net and is overwritten
+    // Point k of row r at level l - 1 reads points k and k + 1 of row r + 1 and point k of row r at level l
+    // Every read is at or after the written index so nothing is overwritten before it is used
+    template<unsigned N>
+    void EvaluateLanes(Simd::Vector3Lanes (&points)[BezierTriangle<N>::NumControlPoints], Simd::FloatLanes u, Simd::FloatLanes v, Simd::FloatLanes w, Simd::Vector3Lanes& position, Simd::Vector3Lanes& normal)
+    {
+        using namespace Simd;
+        static_assert(N >= 1, "Patch must be at least linear.");
+
+        for (unsigned level = N; level > 1; --level)
+        {
+            for (unsigned row = 0; row < level; ++row)
+            {
+                unsigned const rowStart = row * (row + 1) / 2;
+                unsigned const nextRowStart = (row + 1) * (row + 2) / 2;
+                for (unsigned k = 0; k <= row; ++k)
+                {
+                    points[rowStart + k] = points[nextRowStart + k] * u + points[rowStart + k] * v + points[nextRowStart + k + 1] * w;
+                }
+            }
+        }
+
+        Vector3Lanes const& p010 = points[TriangularIndex<1>::To1D(1, 0)];
+        Vector3Lanes const& p100 = points[TriangularIndex<1>::To1D(0, 0)];
+        Vector3Lanes const& p001 = points[TriangularIndex<1>::To1D(0, 1)];
+
+        position = p100 * u + p010 * v + p001 * w;
+        normal = Normalize(Cross(Normalize(p100 - p010), Normalize(p001 - p010)));
+    }
+
+    // Positions and normals of one patch for one register of samples
+    template<unsigned N>
+    void EvaluateLanes(BezierTriangle<N> const& patch, Simd::FloatLanes u, Simd::FloatLanes v, Simd::FloatLanes w, Simd::Vector3Lanes& position, Simd::Vector3Lanes& normal)
+    {
+        using namespace Simd;
+
+        Vector3Lanes points[BezierTriangle<N>::NumControlPoints];
+        for (unsigned i = 0; i < BezierTriangle<N>::NumControlPoints; ++i)
+        {
+            points[i] = { Set1(patch.ControlPoints[i].x), Set1(patch.ControlPoints[i].y), Set1(patch.ControlPoints[i].z) };
+        }
+
+        EvaluateLanes<N>(points, u, v, w, position, normal);
+    }
+
+    // Evaluates every sample of a patch, Simd::FloatLanes::Width at a time
+    // Matches Evaluate(patch, uvw) to within 1e-5 times the largest control point magnitude for positions and 1e-5 per normal component,
+    // the only differences come from the order the normalisations and cross product are evaluated in
+    // Streams may be unaligned, a tail shorter than the register width goes through a padded copy
+    template<unsigned N>
+    void EvaluateBatch(BezierTriangle<N> const& patch, BarycentricSamples const& samples, VertexStreams const& out)
+    {
+        using namespace Simd;
+        constexpr unsigned Width = FloatLanes::Width;
+
+        size_t const count = samples.Count();
+        assert(samples.V.Size == count && samples.W.Size == count);
+        assert(out.PositionX.Size >= count && out.PositionY.Size >= count && out.PositionZ.Size >= count);
+        assert(out.NormalX.Size >= count && out.NormalY.Size >= count && out.NormalZ.Size >= count);
+
+        Vector3Lanes position, normal;
+        size_t i = 0;
+        for (; i + Width <= count; i += Width)
+        {
+            EvaluateLanes(patch, LoadUnaligned(&samples.U[i]), LoadUnaligned(&samples.V[i]), LoadUnaligned(&samples.W[i]), position, normal);
+
+            StoreUnaligned(&out.PositionX[i], position.x);
+            StoreUnaligned(&out.PositionY[i], position.y);
+            StoreUnaligned(&out.PositionZ[i], position.z);
+            StoreUnaligned(&out.NormalX[i], normal.x);
+            StoreUnaligned(&out.NormalY[i], normal.y);
+            StoreUnaligned(&out.NormalZ[i], normal.z);
+        }
+
+        if (i < count)
+        {
+            size_t const tail = count - i;
+
+            // Pad with a valid corner so the unused lanes stay finite
+            float u[Width] = {}, v[Width] = {}, w[Width] = {};
+            std::fill(std::begin(u), std::end(u), 1.f);
+            std::copy_n(&samples.U[i], tail, u);
+            std::copy_n(&samples.V[i], tail, v);
+            std::copy_n(&samples.W[i], tail, w);
+
+            EvaluateLanes(patch, LoadUnaligned(u), LoadUnaligned(v), LoadUnaligned(w), position, normal);
+
+            float lanes[6][Width];
+            StoreUnaligned(lanes[0], position.x);
+            StoreUnaligned(lanes[1], position.y);
+            StoreUnaligned(lanes[2], position.z);
+            StoreUnaligned(lanes[3], normal.x);
+            StoreUnaligned(lanes[4], normal.y);
+            StoreUnaligned(lanes[5], normal.z);
+
+            std::copy_n(lanes[0], tail, &out.PositionX[i]);
+            std::copy_n(lanes[1], tail, &out.PositionY[i]);
+            std::copy_n(lanes[2], tail, &out.PositionZ[i]);
+            std::copy_n(lanes[3], tail, &out.NormalX[i]);
+            std::copy_n(lanes[4], tail, &out.NormalY[i]);
+            std::copy_n(lanes[5], tail, &out.NormalZ[i]);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include "stdafx.h"
+#include "BezierBinaryIO.h"
+
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <filesystem>
+
+using namespace BezierMaths;
+
+namespace BezierFileIO
+{
+    namespace
+    {
+        std::string ToString(std::wstring const& filePath)
+        {
+            return std::filesystem::path(filePath).string();
+        }
+
+        uint64_t BytesPerPatch(uint32_t degree)
+        {
+            return uint64_t(NumTriangleControlPoints(degree)) * sizeof(ControlPoint);
+        }
+    }
+
+    uint64_t ComputeChecksum(void const* data, size_t size)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (uint8_t const* byte = static_cast<uint8_t const*>(data), *end = byte + size; byte != end; ++byte)
+        {
+            hash = (hash ^ *byte) * 1099511628211ull;
+        }
+
+        return hash;
+    }
+
+    void WriteBinaryFile(std::wstring const& filePath, unsigned degree, Span<ControlPoint const> controlPoints)
+    {
+        if (degree == 0 || degree > BinaryPatchHeader::MaxDegree)
+        {
+            throw std::runtime_error("Binary patch files hold degrees 1 to " + std::to_string(BinaryPatchHeader::MaxDegree) + ", got " + std::to_string(degree) + ".");
+        }
+
+        size_t const numControlPoints = NumTriangleControlPoints(degree);
+        if (controlPoints.Size % numControlPoints != 0)
+        {
+            throw std::runtime_error(std::to_string(controlPoints.Size) + " control points aren't a whole number of degree " + std::to_string(degree) + " patches.");
+        }
+
+        if (std::filesystem::exists(std::filesystem::path(filePath)))
+        {
+            throw std::runtime_error("File " + ToString(filePath) + " already exists.");
+        }
+
+        BinaryPatchHeader header;
+        header.Degree = degree;
+        header.NumPatches = controlPoints.Size / numControlPoints;
+        header.DataOffset = sizeof(BinaryPatchHeader);
+        header.DataSize = controlPoints.Size * sizeof(ControlPoint);
+        header.Checksum = ComputeChecksum(controlPoints.Data, static_cast<size_t>(header.DataSize));
+
+        std::ofstream file(std::filesystem::path(filePath), std::ios::binary);
+        file.write(reinterpret_cast<char const*>(&header), sizeof(header));
+        file.write(reinterpret_cast<char const*>(controlPoints.Data), static_cast<std::streamsize>(header.DataSize));
+
+        // Closing flushes whatever is still buffered, which can fail after every write succeeded
+        file.close();
+        if (!file)
+        {
+            throw std::runtime_error("Couldn't write " + ToString(filePath) + ".");
+        }
+    }
+
+    MappedPatchFile::MappedPatchFile(std::wstring const& filePath, bool verifyChecksum)
+    {
+        HANDLE const file = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            throw std::runtime_error("Couldn't open " + ToString(filePath) + ".");
+        }
+
+        m_file = file;
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || uint64_t(fileSize.QuadPart) < sizeof(BinaryPatchHeader))
+        {
+            Close();
+            throw std::runtime_error(ToString(filePath) + " is too small to be a binary patch file.");
+        }
+
+        m_fileSize = uint64_t(fileSize.QuadPart);
+        m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        m_view = m_mapping ? MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!m_view)
+        {
+            Close();
+            throw std::runtime_error("Couldn't map " + ToString(filePath) + ".");
+        }
+
+        // Only the header is read here, the pages holding the control points are faulted in when they are first touched
+        BinaryPatchHeader const& header = GetHeader();
+        std::string error;
+        if (!std::equal(header.Magic, header.Magic + 4, BinaryPatchHeader::MagicBytes))
+        {
+            error = " isn't a binary patch file.";
+        }
+        else if (header.Version != BinaryPatchHeader::CurrentVersion)
+        {
+            error = " has format version " + std::to_string(header.Version) + ", expected " + std::to_string(BinaryPatchHeader::CurrentVersion) + ".";
+        }
+        else if (header.Layout != ControlPointLayout::Packed)
+        {
+            error = " has an unknown control point layout.";
+        }
+        else if (header.Degree == 0 || header.Degree > BinaryPatchHeader::MaxDegree)
+        {
+            error = " has degree " + std::to_string(header.Degree) + ", expected 1 to " + std::to_string(BinaryPatchHeader::MaxDegree) + ".";
+        }
+        else if (header.DataOffset < sizeof(BinaryPatchHeader) || header.DataOffset % sizeof(BinaryPatchHeader) != 0 || header.DataOffset > m_fileSize || header.DataSize > m_fileSize - header.DataOffset ||
+                 header.DataSize % BytesPerPatch(header.Degree) != 0 || header.NumPatches != header.DataSize / BytesPerPatch(header.Degree))
+        {
+            // Every field is untrusted, the data can't overlap the header and comparing by dividing the data size keeps a huge patch count from wrapping
+            error = " has a header that doesn't match its size.";
+        }
+        else if (verifyChecksum && !VerifyChecksum())
+        {
+            error = " failed its checksum.";
+        }
+
+        if (!error.empty())
+        {
+            Close();
+            throw std::runtime_error(ToString(filePath) + error);
+        }
+    }
+
+    MappedPatchFile::~MappedPatchFile()
+    {
+        Close();
+    }
+
+    MappedPatchFile::MappedPatchFile(MappedPatchFile&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    MappedPatchFile& MappedPatchFile::operator=(MappedPatchFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Close();
+            std::swap(m_file, other.m_file);
+            std::swap(m_mapping, other.m_mapping);
+            std::swap(m_view, other.m_view);
+            std::swap(m_fileSize, other.m_fileSize);
+        }
+
+        return *this;
+    }
+
+    bool MappedPatchFile::VerifyChecksum() const
+    {
+        BinaryPatchHeader const& header = GetHeader();
+        return ComputeChecksum(static_cast<char const*>(m_view) + header.DataOffset, static_cast<size_t>(header.DataSize)) == header.Checksum;
+    }
+
+    void MappedPatchFile::Close()
+    {
+        if (m_view)
+        {
+            UnmapViewOfFile(m_view);
+        }
+
+        if (m_mapping)
+        {
+            CloseHandle(m_mapping);
+        }
+
+        if (m_file)
+        {
+            CloseHandle(m_file);
+        }
+
+        m_file = nullptr;
+        m_mapping = nullptr;
+        m_view = nullptr;
+        m_fileSize = 0;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+#include "BezierMaths.h"
+#include "BezierPatchStore.h"
+#include "BezierTriangleView.h"
+
+namespace BezierFileIO
+{
+    // Layout of the float arrays after the header
+    enum class ControlPointLayout : uint32_t
+    {
+        // x, y, z per control point, patch after patch, the layout the mesh shader's Patches buffer reads
+        Packed = 0,
+    };
+
+    // Binary .bezb files are this header followed by the control points at DataOffset
+    // Every field is little endian, DataOffset is a nonzero multiple of the header size so the floats stay cache line aligned in a mapped view
+    struct BinaryPatchHeader
+    {
+        static constexpr char MagicBytes[4] = { 'B', 'E', 'Z', 'B' };
+        static constexpr uint32_t CurrentVersion = 1;
+
+        // Largest degree a file may hold, keeps the size of a patch far from overflowing when a header is checked
+        static constexpr uint32_t MaxDegree = 1024;
+
+        char Magic[4] = { MagicBytes[0], MagicBytes[1], MagicBytes[2], MagicBytes[3] };
+        uint32_t Version = CurrentVersion;
+        uint32_t Degree = 0;
+        ControlPointLayout Layout = ControlPointLayout::Packed;
+        uint64_t NumPatches = 0;
+        uint64_t DataOffset = 0;
+        uint64_t DataSize = 0;
+
+        // ComputeChecksum of the DataSize bytes at DataOffset
+        uint64_t Checksum = 0;
+        uint8_t Reserved[16] = {};
+    };
+
+    static_assert(sizeof(BinaryPatchHeader) == 64, "The header is part of the file format.");
+
+    // 64 bit FNV-1a
+    uint64_t ComputeChecksum(void const* data, size_t size);
+
+    // Writes patches of degree whose control points follow each other in controlPoints, the count has to be a whole number of patches
+    // Throws if the file already exists, like WriteToFile
+    void WriteBinaryFile(std::wstring const& filePath, unsigned degree, BezierMaths::Span<BezierMaths::ControlPoint const> controlPoints);
+
+    template<unsigned N>
+    void WriteBinaryFile(std::wstring const& filePath, BezierMaths::BezierTriangle<N> const& patch)
+    {
+        WriteBinaryFile(filePath, N, { patch.ControlPoints, BezierMaths::BezierTriangle<N>::NumControlPoints });
+    }
+
+    template<unsigned N, unsigned M>
+    void WriteBinaryFile(std::wstring const& filePath, BezierMaths::BezierShape<N, M> const& shape)
+    {
+        // Patches are arrays of control points with nothing in between, so the whole shape is one run
+        static_assert(sizeof(shape.Patches) == sizeof(BezierMaths::ControlPoint) * BezierMaths::BezierTriangle<N>::NumControlPoints * M, "Patches must be tightly packed.");
+        WriteBinaryFile(filePath, N, { shape.Patches[0].ControlPoints, size_t(BezierMaths::BezierTriangle<N>::NumControlPoints) * M });
+    }
+
+    template<unsigned N>
+    void WriteBinaryFile(std::wstring const& filePath, BezierMaths::BezierPatchStore<N> const& store)
+    {
+        WriteBinaryFile(filePath, N, store.GetPackedControlPoints());
+    }
+
+    // Read only view of a binary patch file mapped into memory
+    // Opening checks the header and the file size but doesn't touch the control points, so it takes the same time for any file size
+    // The checksum is only checked on request since it has to read every byte
+    class MappedPatchFile
+    {
+    public:
+        MappedPatchFile() = default;
+
+        // Throws std::runtime_error if the file can't be mapped or isn't a valid patch file
+        explicit MappedPatchFile(std::wstring const& filePath, bool verifyChecksum = false);
+        ~MappedPatchFile();
+
+        MappedPatchFile(MappedPatchFile&& other) noexcept;
+        MappedPatchFile& operator=(MappedPatchFile&& other) noexcept;
+        MappedPatchFile(MappedPatchFile const&) = delete;
+        MappedPatchFile& operator=(MappedPatchFile const&) = delete;
+
+        bool IsOpen() const { return m_view != nullptr; }
+        BinaryPatchHeader const& GetHeader() const { return *static_cast<BinaryPatchHeader const*>(m_view); }
+
+        unsigned GetDegree() const { return GetHeader().Degree; }
+        size_t GetNumPatches() const { return static_cast<size_t>(GetHeader().NumPatches); }
+
+        // Every control point of every patch, valid while the file stays open
+        BezierMaths::Span<BezierMaths::ControlPoint const> GetControlPoints() const
+        {
+            return { reinterpret_cast<BezierMaths::ControlPoint const*>(static_cast<char const*>(m_view) + GetHeader().DataOffset),
+                     static_cast<size_t>(GetHeader().DataSize / sizeof(BezierMaths::ControlPoint)) };
+        }
+
+        BezierMaths::BezierTriangleView GetPatch(size_t index) const
+        {
+            size_t const numControlPoints = BezierMaths::NumTriangleControlPoints(GetDegree());
+            return { GetDegree(), { GetControlPoints().Data + index * numControlPoints, numControlPoints } };
+        }
+
+        bool VerifyChecksum() const;
+
+        void Close();
+
+    private:
+        void* m_file = nullptr;
+        void* m_mapping = nullptr;
+        void const* m_view = nullptr;
+        uint64_t m_fileSize = 0;
+    };
+}
\ No newline at end of file
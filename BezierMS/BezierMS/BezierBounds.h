@@ -0,0 +1,406 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+
+#include "BezierMaths.h"
+#include "BezierSimd.h"
+#include "BezierPatchStore.h"
+
+namespace BezierMaths
+{
+    // Axis aligned box and sphere around a patch
+    // A Bezier triangle lies inside the convex hull of its control points, so bounds of the control points bound the surface
+    struct PatchBounds
+    {
+        DirectX::SimpleMath::Vector3 Min = { (std::numeric_limits<float>::max)(), (std::numeric_limits<float>::max)(), (std::numeric_limits<float>::max)() };
+        DirectX::SimpleMath::Vector3 Max = { -(std::numeric_limits<float>::max)(), -(std::numeric_limits<float>::max)(), -(std::numeric_limits<float>::max)() };
+
+        // The sphere is centred on the box so the two stay consistent
+        DirectX::SimpleMath::Vector3 Center;
+        float Radius = 0.f;
+
+        bool Empty() const { return Min.x > Max.x; }
+        DirectX::SimpleMath::Vector3 GetExtents() const { return (Max - Min) * 0.5f; }
+    };
+
+    // Smallest box around both, the sphere is the one around the merged box
+    inline PatchBounds Merge(PatchBounds const& a, PatchBounds const& b)
+    {
+        if (a.Empty())
+        {
+            return b;
+        }
+
+        if (b.Empty())
+        {
+            return a;
+        }
+
+        PatchBounds result;
+        result.Min = DirectX::SimpleMath::Vector3::Min(a.Min, b.Min);
+        result.Max = DirectX::SimpleMath::Vector3::Max(a.Max, b.Max);
+        result.Center = (result.Min + result.Max) * 0.5f;
+        result.Radius = (std::max)((a.Center - result.Center).Length() + a.Radius, (b.Center - result.Center).Length() + b.Radius);
+        return result;
+    }
+
+    enum class Containment
+    {
+        Outside,
+        Intersects,
+        Inside
+    };
+
+    // Six planes with normals pointing into the frustum, a point p is inside a plane when Dot(Normal, p) + Distance >= 0
+    struct Frustum
+    {
+        enum Side { Left, Right, Bottom, Top, Near, Far, NumSides };
+
+        DirectX::SimpleMath::Vector3 Normals[NumSides];
+        float Distances[NumSides] = {};
+
+        // Planes of a row vector view-projection matrix with D3D clip space depth in [0, w]
+        static Frustum FromViewProjection(DirectX::SimpleMath::Matrix const& viewProjection)
+        {
+            auto const& m = viewProjection.m;
+            auto const column = [&m](unsigned c) { return DirectX::SimpleMath::Vector3(m[0][c], m[1][c], m[2][c]); };
+            auto const columnW = [&m](unsigned c) { return m[3][c]; };
+
+            Frustum result;
+            result.Normals[Left] = column(3) + column(0);
+            result.Distances[Left] = columnW(3) + columnW(0);
+            result.Normals[Right] = column(3) - column(0);
+            result.Distances[Right] = columnW(3) - columnW(0);
+            result.Normals[Bottom] = column(3) + column(1);
+            result.Distances[Bottom] = columnW(3) + columnW(1);
+            result.Normals[Top] = column(3) - column(1);
+            result.Distances[Top] = columnW(3) - columnW(1);
+            result.Normals[Near] = column(2);
+            result.Distances[Near] = columnW(2);
+            result.Normals[Far] = column(3) - column(2);
+            result.Distances[Far] = columnW(3) - columnW(2);
+
+            for (unsigned side = 0; side < NumSides; ++side)
+            {
+                float const length = result.Normals[side].Length();
+                result.Normals[side] /= length;
+                result.Distances[side] /= length;
+            }
+
+            return result;
+        }
+    };
+
+    // Box against frustum using the box corners furthest along and against each plane normal
+    // Boxes that straddle two planes outside a frustum corner are reported as intersecting, which is conservative
+    inline Containment Intersects(Frustum const& frustum, DirectX::SimpleMath::Vector3 const& min, DirectX::SimpleMath::Vector3 const& max)
+    {
+        Containment result = Containment::Inside;
+        for (unsigned side = 0; side < Frustum::NumSides; ++side)
+        {
+            auto const& normal = frustum.Normals[side];
+            DirectX::SimpleMath::Vector3 const furthest(normal.x >= 0.f ? max.x : min.x, normal.y >= 0.f ? max.y : min.y, normal.z >= 0.f ? max.z : min.z);
+            if (normal.Dot(furthest) + frustum.Distances[side] < 0.f)
+            {
+                return Containment::Outside;
+            }
+
+            DirectX::SimpleMath::Vector3 const nearest(normal.x >= 0.f ? min.x : max.x, normal.y >= 0.f ? min.y : max.y, normal.z >= 0.f ? min.z : max.z);
+            if (normal.Dot(nearest) + frustum.Distances[side] < 0.f)
+            {
+                result = Containment::Intersects;
+            }
+        }
+
+        return result;
+    }
+
+    inline Containment Intersects(Frustum const& frustum, PatchBounds const& bounds)
+    {
+        return Intersects(frustum, bounds.Min, bounds.Max);
+    }
+
+    // Bounds of FloatLanes::Width patches held lane by lane in points, writes the first count of them to out
+    // Every bounds path goes through here so a patch gets the same bounds whichever container it sits in
+    template<unsigned N>
+    void ComputeBoundsLanes(Simd::Vector3Lanes const (&points)[BezierTriangle<N>::NumControlPoints], size_t count, PatchBounds* out)
+    {
+        using namespace Simd;
+        constexpr unsigned Width = FloatLanes::Width;
+
+        Vector3Lanes minimum = points[0];
+        Vector3Lanes maximum = minimum;
+        for (unsigned slot = 1; slot < BezierTriangle<N>::NumControlPoints; ++slot)
+        {
+            minimum = { Min(minimum.x, points[slot].x), Min(minimum.y, points[slot].y), Min(minimum.z, points[slot].z) };
+            maximum = { Max(maximum.x, points[slot].x), Max(maximum.y, points[slot].y), Max(maximum.z, points[slot].z) };
+        }
+
+        Vector3Lanes const center = (minimum + maximum) * Set1(0.5f);
+
+        FloatLanes radiusSquared = Set1(0.f);
+        for (unsigned slot = 0; slot < BezierTriangle<N>::NumControlPoints; ++slot)
+        {
+            Vector3Lanes const offset = points[slot] - center;
+            radiusSquared = Max(radiusSquared, Dot(offset, offset));
+        }
+
+        alignas(CacheLineAlignment) float lanes[10][Width];
+        Store(lanes[0], minimum.x);
+        Store(lanes[1], minimum.y);
+        Store(lanes[2], minimum.z);
+        Store(lanes[3], maximum.x);
+        Store(lanes[4], maximum.y);
+        Store(lanes[5], maximum.z);
+        Store(lanes[6], center.x);
+        Store(lanes[7], center.y);
+        Store(lanes[8], center.z);
+        Store(lanes[9], Sqrt(radiusSquared));
+
+        for (size_t lane = 0; lane < count; ++lane)
+        {
+            out[lane].Min = { lanes[0][lane], lanes[1][lane], lanes[2][lane] };
+            out[lane].Max = { lanes[3][lane], lanes[4][lane], lanes[5][lane] };
+            out[lane].Center = { lanes[6][lane], lanes[7][lane], lanes[8][lane] };
+            out[lane].Radius = lanes[9][lane];
+        }
+    }
+
+    // Bounds of count patches starting at patches, count must be at most FloatLanes::Width
+    // The control points are gathered into lanes, the unused lanes repeat the last patch so they stay finite
+    template<unsigned N>
+    void ComputeBounds(BezierTriangle<N> const* patches, size_t count, PatchBounds* out)
+    {
+        using namespace Simd;
+        constexpr unsigned Width = FloatLanes::Width;
+        assert(count > 0 && count <= Width);
+
+        Vector3Lanes points[BezierTriangle<N>::NumControlPoints];
+        for (unsigned slot = 0; slot < BezierTriangle<N>::NumControlPoints; ++slot)
+        {
+            alignas(CacheLineAlignment) float lanes[3][Width];
+            for (unsigned lane = 0; lane < Width; ++lane)
+            {
+                ControlPoint const& point = patches[(std::min)(size_t(lane), count - 1)].ControlPoints[slot];
+                lanes[0][lane] = point.x;
+                lanes[1][lane] = point.y;
+                lanes[2][lane] = point.z;
+            }
+
+            points[slot] = { Load(lanes[0]), Load(lanes[1]), Load(lanes[2]) };
+        }
+
+        ComputeBoundsLanes<N>(points, count, out);
+    }
+
+    template<unsigned N>
+    PatchBounds ComputeBounds(BezierTriangle<N> const& patch)
+    {
+        PatchBounds result;
+        ComputeBounds(&patch, 1, &result);
+        return result;
+    }
+
+    // Bounds of every patch of a shape into out, FloatLanes::Width patches at a time
+    template<unsigned N, unsigned M>
+    void ComputeBounds(BezierShape<N, M> const& shape, PatchBounds* out)
+    {
+        constexpr unsigned Width = Simd::FloatLanes::Width;
+        for (unsigned first = 0; first < M; first += Width)
+        {
+            ComputeBounds(&shape.Patches[first], (std::min)(Width, M - first), &out[first]);
+        }
+    }
+
+    // Union of the patch bounds of a shape
+    template<unsigned N, unsigned M>
+    PatchBounds ComputeBounds(BezierShape<N, M> const& shape)
+    {
+        constexpr unsigned Width = Simd::FloatLanes::Width;
+
+        PatchBounds result;
+        for (unsigned first = 0; first < M; first += Width)
+        {
+            PatchBounds bounds[Width];
+            unsigned const count = (std::min)(Width, M - first);
+            ComputeBounds(&shape.Patches[first], count, bounds);
+            for (unsigned patch = 0; patch < count; ++patch)
+            {
+                result = Merge(result, bounds[patch]);
+            }
+        }
+
+        return result;
+    }
+
+    // Bounds of FloatLanes::Width patches of a store starting at first, first must be a multiple of the width
+    // Writes one entry per patch that exists, at most Width of them
+    template<unsigned N>
+    void ComputeBounds(BezierPatchStore<N> const& store, size_t first, PatchBounds* out)
+    {
+        Simd::Vector3Lanes points[BezierTriangle<N>::NumControlPoints];
+        for (unsigned slot = 0; slot < BezierTriangle<N>::NumControlPoints; ++slot)
+        {
+            points[slot] = store.LoadControlPoint(slot, first);
+        }
+
+        ComputeBoundsLanes<N>(points, (std::min)(size_t(Simd::FloatLanes::Width), store.GetNumPatches() - first), out);
+    }
+
+    // Per patch bounds of a store that are only recomputed for patches edited since the last Update
+    // Patches are compared against the store's per patch versions, so edits made through any path are picked up
+    template<unsigned N>
+    class PatchBoundsCache
+    {
+    public:
+        // Brings the cache in line with store and returns the number of patches whose bounds were recomputed
+        size_t Update(BezierPatchStore<N> const& store)
+        {
+            size_t const numPatches = store.GetNumPatches();
+            if (numPatches == m_bounds.size() && store.GetVersion() == m_version)
+            {
+                return 0;
+            }
+
+            m_bounds.resize(numPatches);
+            m_patchVersions.resize(numPatches, 0);
+
+            // Any stale patch in a register of patches recomputes the whole register, it costs the same as one patch
+            size_t numUpdated = 0;
+            constexpr unsigned Width = Simd::FloatLanes::Width;
+            for (size_t first = 0; first < numPatches; first += Width)
+            {
+                size_t const last = (std::min)(first + Width, numPatches);
+
+                bool stale = false;
+                for (size_t patch = first; patch < last; ++patch)
+                {
+                    if (m_patchVersions[patch] != store.GetPatchVersion(patch))
+                    {
+                        m_patchVersions[patch] = store.GetPatchVersion(patch);
+                        stale = true;
+                        ++numUpdated;
+                    }
+                }
+
+                if (stale)
+                {
+                    ComputeBounds(store, first, &m_bounds[first]);
+                }
+            }
+
+            if (numUpdated > 0 || m_version != store.GetVersion())
+            {
+                m_shapeBounds = PatchBounds{};
+                for (auto const& bounds : m_bounds)
+                {
+                    m_shapeBounds = Merge(m_shapeBounds, bounds);
+                }
+            }
+
+            m_version = store.GetVersion();
+            return numUpdated;
+        }
+
+        // Forgets every cached entry so the next Update recomputes all of them
+        void Invalidate()
+        {
+            m_bounds.clear();
+            m_patchVersions.clear();
+            m_version = 0;
+        }
+
+        PatchBounds const& Get(size_t index) const { return m_bounds[index]; }
+        Span<PatchBounds const> GetBounds() const { return { m_bounds.data(), m_bounds.size() }; }
+
+        // Union of every patch
+        PatchBounds const& GetShapeBounds() const { return m_shapeBounds; }
+
+    private:
+        std::vector<PatchBounds> m_bounds;
+        std::vector<uint64_t> m_patchVersions;
+        uint64_t m_version = 0;
+        PatchBounds m_shapeBounds;
+    };
+
+    // Cached bounds for a BezierShape, whose patches are edited directly so the caller flags what changed
+    template<unsigned N, unsigned M>
+    class ShapeBoundsCache
+    {
+    public:
+        ShapeBoundsCache()
+        {
+            MarkAllDirty();
+        }
+
+        void MarkDirty(unsigned patchIndex)
+        {
+            assert(patchIndex < M);
+            m_dirty[patchIndex] = true;
+            m_shapeDirty = true;
+        }
+
+        void MarkAllDirty()
+        {
+            std::fill(std::begin(m_dirty), std::end(m_dirty), true);
+            m_shapeDirty = true;
+        }
+
+        PatchBounds const& Get(BezierShape<N, M> const& shape, unsigned patchIndex)
+        {
+            assert(patchIndex < M);
+            if (m_dirty[patchIndex])
+            {
+                m_bounds[patchIndex] = ComputeBounds(shape.Patches[patchIndex]);
+                m_dirty[patchIndex] = false;
+            }
+
+            return m_bounds[patchIndex];
+        }
+
+        // Bounds of every patch in patch order
+        Span<PatchBounds const> GetBounds(BezierShape<N, M> const& shape)
+        {
+            // Like PatchBoundsCache, a dirty patch recomputes its whole register of patches
+            constexpr unsigned Width = Simd::FloatLanes::Width;
+            for (unsigned first = 0; first < M; first += Width)
+            {
+                unsigned const count = (std::min)(Width, M - first);
+                if (std::any_of(&m_dirty[first], &m_dirty[first] + count, [](bool dirty) { return dirty; }))
+                {
+                    ComputeBounds(&shape.Patches[first], count, &m_bounds[first]);
+                    std::fill_n(&m_dirty[first], count, false);
+                }
+            }
+
+            return { m_bounds, M };
+        }
+
+        PatchBounds const& GetShapeBounds(BezierShape<N, M> const& shape)
+        {
+            if (m_shapeDirty)
+            {
+                m_shapeBounds = PatchBounds{};
+                for (unsigned patch = 0; patch < M; ++patch)
+                {
+                    m_shapeBounds = Merge(m_shapeBounds, Get(shape, patch));
+                }
+
+                m_shapeDirty = false;
+            }
+
+            return m_shapeBounds;
+        }
+
+    private:
+        PatchBounds m_bounds[M];
+        bool m_dirty[M];
+        bool m_shapeDirty = true;
+        PatchBounds m_shapeBounds;
+    };
+}
\ No newline at end of file
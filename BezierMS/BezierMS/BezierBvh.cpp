@@ -0,0 +1,264 @@
+#include "stdafx.h"
+#include "BezierBvh.h"
+#include "ThreadPool.h"
+
+#include <numeric>
+
+using namespace DirectX::SimpleMath;
+
+namespace BezierMaths
+{
+    namespace
+    {
+        struct Box
+        {
+            Vector3 Min = Vector3((std::numeric_limits<float>::max)());
+            Vector3 Max = Vector3(-(std::numeric_limits<float>::max)());
+
+            void Grow(Vector3 const& min, Vector3 const& max)
+            {
+                Min = Vector3::Min(Min, min);
+                Max = Vector3::Max(Max, max);
+            }
+
+            float HalfArea() const
+            {
+                Vector3 const size = Max - Min;
+                return size.x * size.y + size.y * size.z + size.z * size.x;
+            }
+        };
+
+        float GetAxis(Vector3 const& v, unsigned axis)
+        {
+            return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+        }
+    }
+
+    struct PatchBvh::BuildState
+    {
+        Span<PatchBounds const> Bounds;
+        std::vector<Vector3> Centroids;
+
+        // Every subtree gets a fixed range of this array up front so subtrees can be built on any thread in any order
+        std::vector<Node> Nodes;
+        std::vector<uint32_t> PatchIndices;
+        ThreadPool* Pool = nullptr;
+    };
+
+    void PatchBvh::Build(Span<PatchBounds const> bounds, ThreadPool* pool)
+    {
+        m_nodes.clear();
+        m_patchIndices.clear();
+        m_patchBoxes.clear();
+        if (bounds.Empty())
+        {
+            return;
+        }
+
+        uint32_t const numPatches = static_cast<uint32_t>(bounds.Size);
+
+        BuildState state;
+        state.Bounds = bounds;
+        state.Pool = pool;
+        state.Centroids.resize(numPatches);
+        for (uint32_t i = 0; i < numPatches; ++i)
+        {
+            state.Centroids[i] = (bounds[i].Min + bounds[i].Max) * 0.5f;
+        }
+
+        state.PatchIndices.resize(numPatches);
+        std::iota(state.PatchIndices.begin(), state.PatchIndices.end(), 0u);
+
+        // A binary tree with n leaves has at most 2n - 1 nodes
+        state.Nodes.resize(size_t(numPatches) * 2 - 1);
+        BuildNode(state, 0, 0, numPatches, 1, 0);
+
+        // Pack the used nodes breadth first, siblings stay next to each other
+        m_nodes.reserve(state.Nodes.size());
+        m_nodes.push_back(state.Nodes[0]);
+        for (size_t i = 0; i < m_nodes.size(); ++i)
+        {
+            if (!m_nodes[i].IsLeaf())
+            {
+                uint32_t const firstChild = m_nodes[i].LeftOrFirst;
+                m_nodes[i].LeftOrFirst = static_cast<uint32_t>(m_nodes.size());
+                m_nodes.push_back(state.Nodes[firstChild]);
+                m_nodes.push_back(state.Nodes[firstChild + 1]);
+            }
+        }
+
+        m_nodes.shrink_to_fit();
+        m_patchIndices = std::move(state.PatchIndices);
+
+        m_patchBoxes.resize(numPatches);
+        for (uint32_t i = 0; i < numPatches; ++i)
+        {
+            m_patchBoxes[i] = { bounds[m_patchIndices[i]].Min, bounds[m_patchIndices[i]].Max };
+        }
+    }
+
+    // Descendants of nodeIndex go to [childBase, childBase + 2 * (end - begin - 1)), children first
+    void PatchBvh::BuildNode(BuildState& state, uint32_t nodeIndex, uint32_t begin, uint32_t end, uint32_t childBase, unsigned depth)
+    {
+        uint32_t* const indices = state.PatchIndices.data();
+        uint32_t const count = end - begin;
+
+        Box box, centroidBox;
+        for (uint32_t i = begin; i < end; ++i)
+        {
+            box.Grow(state.Bounds[indices[i]].Min, state.Bounds[indices[i]].Max);
+            centroidBox.Grow(state.Centroids[indices[i]], state.Centroids[indices[i]]);
+        }
+
+        Node& node = state.Nodes[nodeIndex];
+        node.Min = box.Min;
+        node.Max = box.Max;
+
+        auto const makeLeaf = [&]()
+        {
+            node.LeftOrFirst = begin;
+            node.Count = count;
+        };
+
+        if (count == 1)
+        {
+            makeLeaf();
+            return;
+        }
+
+        Vector3 const centroidExtent = centroidBox.Max - centroidBox.Min;
+        unsigned widestAxis = centroidExtent.x >= centroidExtent.y ? 0 : 1;
+        widestAxis = GetAxis(centroidExtent, widestAxis) >= centroidExtent.z ? widestAxis : 2;
+
+        uint32_t middle = begin;
+
+        // Binned surface area heuristic, a split costs one traversal step plus each side's patches weighted by its share of the area
+        if (depth < MedianSplitDepth && GetAxis(centroidExtent, widestAxis) > 0.f)
+        {
+            float bestCost = (std::numeric_limits<float>::max)();
+            unsigned bestAxis = 0, bestSplit = 0;
+            for (unsigned axis = 0; axis < 3; ++axis)
+            {
+                float const extent = GetAxis(centroidExtent, axis);
+                if (extent <= 0.f)
+                {
+                    continue;
+                }
+
+                Box bins[NumBins];
+                uint32_t binCounts[NumBins] = {};
+                float const scale = NumBins / extent;
+                for (uint32_t i = begin; i < end; ++i)
+                {
+                    unsigned const bin = (std::min)(NumBins - 1, static_cast<unsigned>((GetAxis(state.Centroids[indices[i]], axis) - GetAxis(centroidBox.Min, axis)) * scale));
+                    bins[bin].Grow(state.Bounds[indices[i]].Min, state.Bounds[indices[i]].Max);
+                    ++binCounts[bin];
+                }
+
+                // Sweep from the right to get the cost of everything after each split plane
+                float rightCosts[NumBins] = {};
+                Box right;
+                uint32_t rightCount = 0;
+                for (unsigned split = NumBins - 1; split > 0; --split)
+                {
+                    right.Grow(bins[split].Min, bins[split].Max);
+                    rightCount += binCounts[split];
+                    rightCosts[split] = rightCount > 0 ? right.HalfArea() * rightCount : 0.f;
+                }
+
+                Box left;
+                uint32_t leftCount = 0;
+                for (unsigned split = 1; split < NumBins; ++split)
+                {
+                    left.Grow(bins[split - 1].Min, bins[split - 1].Max);
+                    leftCount += binCounts[split - 1];
+                    if (leftCount == 0 || leftCount == count)
+                    {
+                        continue;
+                    }
+
+                    float const cost = left.HalfArea() * leftCount + rightCosts[split];
+                    if (cost < bestCost)
+                    {
+                        bestCost = cost;
+                        bestAxis = axis;
+                        bestSplit = split;
+                    }
+                }
+            }
+
+            float const area = (std::max)(box.HalfArea(), (std::numeric_limits<float>::min)());
+            if (count <= MaxLeafSize && 1.f + bestCost / area >= float(count))
+            {
+                makeLeaf();
+                return;
+            }
+
+            if (bestSplit > 0)
+            {
+                float const extent = GetAxis(centroidExtent, bestAxis);
+                float const scale = NumBins / extent;
+                float const axisMin = GetAxis(centroidBox.Min, bestAxis);
+                middle = static_cast<uint32_t>(std::partition(indices + begin, indices + end, [&](uint32_t patch)
+                {
+                    return (std::min)(NumBins - 1, static_cast<unsigned>((GetAxis(state.Centroids[patch], bestAxis) - axisMin) * scale)) < bestSplit;
+                }) - indices);
+            }
+        }
+        else if (count <= MaxLeafSize)
+        {
+            makeLeaf();
+            return;
+        }
+
+        // Median split when binning can't separate the patches or the tree is already deep
+        if (middle == begin || middle == end)
+        {
+            middle = begin + count / 2;
+            std::nth_element(indices + begin, indices + middle, indices + end, [&](uint32_t a, uint32_t b)
+            {
+                return GetAxis(state.Centroids[a], widestAxis) < GetAxis(state.Centroids[b], widestAxis);
+            });
+        }
+
+        node.LeftOrFirst = childBase;
+        node.Count = 0;
+
+        uint32_t const leftCount = middle - begin;
+        uint32_t const childBases[2] = { childBase + 2, childBase + 2 + 2 * (leftCount - 1) };
+        uint32_t const ranges[3] = { begin, middle, end };
+
+        auto const buildChild = [&](size_t child)
+        {
+            BuildNode(state, childBase + uint32_t(child), ranges[child], ranges[child + 1], childBases[child], depth + 1);
+        };
+
+        if (state.Pool && count >= ParallelBuildThreshold)
+        {
+            state.Pool->ParallelFor(2, 1, [&](size_t first, size_t last)
+            {
+                for (size_t child = first; child < last; ++child)
+                {
+                    buildChild(child);
+                }
+            });
+        }
+        else
+        {
+            buildChild(0);
+            buildChild(1);
+        }
+    }
+
+    float PatchBvh::IntersectRay(Vector3 const& min, Vector3 const& max, Vector3 const& origin, Vector3 const& inverseDirection, float maxDistance)
+    {
+        Vector3 const t0 = (min - origin) * inverseDirection;
+        Vector3 const t1 = (max - origin) * inverseDirection;
+        Vector3 const tNear = Vector3::Min(t0, t1);
+        Vector3 const tFar = Vector3::Max(t0, t1);
+
+        float const entry = (std::max)((std::max)(tNear.x, tNear.y), (std::max)(tNear.z, 0.f));
+        float const exit = (std::min)((std::min)(tFar.x, tFar.y), (std::min)(tFar.z, maxDistance));
+        return entry <= exit ? entry : -1.f;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+#include "BezierMaths.h"
+#include "BezierBounds.h"
+
+class ThreadPool;
+
+namespace BezierMaths
+{
+    // Bounding volume hierarchy over patch bounds
+    // Nodes live in one array in breadth first order with siblings next to each other, so an interior node only stores its first child
+    // Leaves point at a run of GetPatchIndices, queries test each patch's own box in a leaf and report original patch indices
+    class PatchBvh
+    {
+    public:
+        // Two nodes per cache line
+        struct Node
+        {
+            DirectX::SimpleMath::Vector3 Min;
+
+            // First child for interior nodes, first entry of the patch indices for leaves
+            uint32_t LeftOrFirst = 0;
+
+            DirectX::SimpleMath::Vector3 Max;
+
+            // Number of patches for leaves, 0 for interior nodes
+            uint32_t Count = 0;
+
+            bool IsLeaf() const { return Count > 0; }
+        };
+
+        static constexpr unsigned NumBins = 16;
+        static constexpr unsigned MaxLeafSize = 4;
+
+        // Deepest tree the queries can walk
+        // Below MedianSplitDepth the build splits at the median, which adds at most 32 more levels for any 32 bit patch count
+        static constexpr unsigned MaxDepth = 64;
+        static constexpr unsigned MedianSplitDepth = 30;
+
+        // Smallest subtree worth handing to another thread
+        static constexpr uint32_t ParallelBuildThreshold = 4096;
+
+        PatchBvh() = default;
+
+        // Builds over bounds, subtrees with at least ParallelBuildThreshold patches are built as pool tasks when a pool is given
+        // Node layout and patch order don't depend on the pool
+        explicit PatchBvh(Span<PatchBounds const> bounds, ThreadPool* pool = nullptr)
+        {
+            Build(bounds, pool);
+        }
+
+        void Build(Span<PatchBounds const> bounds, ThreadPool* pool = nullptr);
+
+        bool Empty() const { return m_nodes.empty(); }
+        Span<Node const> GetNodes() const { return { m_nodes.data(), m_nodes.size() }; }
+        Span<uint32_t const> GetPatchIndices() const { return { m_patchIndices.data(), m_patchIndices.size() }; }
+
+        // Calls visit(patchIndex) for every patch whose box isn't outside frustum
+        // Subtrees whose box is fully inside are reported without testing their children
+        template<typename Visitor>
+        void QueryFrustum(Frustum const& frustum, Visitor&& visit) const;
+
+        // Calls visit(patchIndex) for every patch whose box overlaps the sphere
+        template<typename Visitor>
+        void QuerySphere(DirectX::SimpleMath::Vector3 const& center, float radius, Visitor&& visit) const;
+
+        // Calls visit(patchIndex, entryDistance) for every patch whose box the ray enters before maxDistance, roughly nearest first
+        // Return false from visit to stop the walk. direction doesn't need to be normalised, distances are in units of its length
+        template<typename Visitor>
+        void QueryRay(DirectX::SimpleMath::Vector3 const& origin, DirectX::SimpleMath::Vector3 const& direction, float maxDistance, Visitor&& visit) const;
+
+        void QueryFrustum(Frustum const& frustum, std::vector<uint32_t>& out) const
+        {
+            QueryFrustum(frustum, [&out](uint32_t patch) { out.push_back(patch); });
+        }
+
+        void QuerySphere(DirectX::SimpleMath::Vector3 const& center, float radius, std::vector<uint32_t>& out) const
+        {
+            QuerySphere(center, radius, [&out](uint32_t patch) { out.push_back(patch); });
+        }
+
+    private:
+        struct BuildState;
+
+        void BuildNode(BuildState& state, uint32_t nodeIndex, uint32_t begin, uint32_t end, uint32_t childBase, unsigned depth);
+
+        template<typename Visitor>
+        void VisitLeaves(Node const& node, Visitor& visit) const;
+
+        // Entry distance of the ray into the box, or a negative value if it misses
+        static float IntersectRay(DirectX::SimpleMath::Vector3 const& min, DirectX::SimpleMath::Vector3 const& max, DirectX::SimpleMath::Vector3 const& origin, DirectX::SimpleMath::Vector3 const& inverseDirection, float maxDistance);
+
+        static bool OverlapsSphere(DirectX::SimpleMath::Vector3 const& min, DirectX::SimpleMath::Vector3 const& max, DirectX::SimpleMath::Vector3 const& center, float radiusSquared)
+        {
+            DirectX::SimpleMath::Vector3 const closest = DirectX::SimpleMath::Vector3::Min(DirectX::SimpleMath::Vector3::Max(center, min), max);
+            return (closest - center).LengthSquared() <= radiusSquared;
+        }
+
+        // Patch boxes in the same order as m_patchIndices, so a leaf reads its boxes from one run
+        struct PatchBox
+        {
+            DirectX::SimpleMath::Vector3 Min;
+            DirectX::SimpleMath::Vector3 Max;
+        };
+
+        std::vector<Node> m_nodes;
+        std::vector<uint32_t> m_patchIndices;
+        std::vector<PatchBox> m_patchBoxes;
+    };
+
+    template<typename Visitor>
+    void PatchBvh::VisitLeaves(Node const& node, Visitor& visit) const
+    {
+        uint32_t stack[MaxDepth];
+        unsigned stackSize = 0;
+
+        Node const* current = &node;
+        while (true)
+        {
+            if (current->IsLeaf())
+            {
+                for (uint32_t i = 0; i < current->Count; ++i)
+                {
+                    visit(m_patchIndices[current->LeftOrFirst + i]);
+                }
+
+                if (stackSize == 0)
+                {
+                    return;
+                }
+
+                current = &m_nodes[stack[--stackSize]];
+            }
+            else
+            {
+                stack[stackSize++] = current->LeftOrFirst + 1;
+                current = &m_nodes[current->LeftOrFirst];
+            }
+        }
+    }
+
+    template<typename Visitor>
+    void PatchBvh::QueryFrustum(Frustum const& frustum, Visitor&& visit) const
+    {
+        if (m_nodes.empty())
+        {
+            return;
+        }
+
+        uint32_t stack[MaxDepth];
+        unsigned stackSize = 0;
+        stack[stackSize++] = 0;
+
+        while (stackSize > 0)
+        {
+            Node const& node = m_nodes[stack[--stackSize]];
+
+            Containment const containment = Intersects(frustum, node.Min, node.Max);
+            if (containment == Containment::Outside)
+            {
+                continue;
+            }
+
+            if (containment == Containment::Inside)
+            {
+                VisitLeaves(node, visit);
+                continue;
+            }
+
+            if (node.IsLeaf())
+            {
+                for (uint32_t i = node.LeftOrFirst; i < node.LeftOrFirst + node.Count; ++i)
+                {
+                    if (Intersects(frustum, m_patchBoxes[i].Min, m_patchBoxes[i].Max) != Containment::Outside)
+                    {
+                        visit(m_patchIndices[i]);
+                    }
+                }
+
+                continue;
+            }
+
+            stack[stackSize++] = node.LeftOrFirst + 1;
+            stack[stackSize++] = node.LeftOrFirst;
+        }
+    }
+
+    template<typename Visitor>
+    void PatchBvh::QuerySphere(DirectX::SimpleMath::Vector3 const& center, float radius, Visitor&& visit) const
+    {
+        if (m_nodes.empty())
+        {
+            return;
+        }
+
+        uint32_t stack[MaxDepth];
+        unsigned stackSize = 0;
+        stack[stackSize++] = 0;
+
+        float const radiusSquared = radius * radius;
+        while (stackSize > 0)
+        {
+            Node const& node = m_nodes[stack[--stackSize]];
+            if (!OverlapsSphere(node.Min, node.Max, center, radiusSquared))
+            {
+                continue;
+            }
+
+            if (node.IsLeaf())
+            {
+                for (uint32_t i = node.LeftOrFirst; i < node.LeftOrFirst + node.Count; ++i)
+                {
+                    if (OverlapsSphere(m_patchBoxes[i].Min, m_patchBoxes[i].Max, center, radiusSquared))
+                    {
+                        visit(m_patchIndices[i]);
+                    }
+                }
+
+                continue;
+            }
+
+            stack[stackSize++] = node.LeftOrFirst + 1;
+            stack[stackSize++] = node.LeftOrFirst;
+        }
+    }
+
+    template<typename Visitor>
+    void PatchBvh::QueryRay(DirectX::SimpleMath::Vector3 const& origin, DirectX::SimpleMath::Vector3 const& direction, float maxDistance, Visitor&& visit) const
+    {
+        if (m_nodes.empty())
+        {
+            return;
+        }
+
+        // Division by a zero component gives an infinity, which the slab test handles
+        DirectX::SimpleMath::Vector3 const inverseDirection(1.f / direction.x, 1.f / direction.y, 1.f / direction.z);
+
+        uint32_t stack[MaxDepth];
+        unsigned stackSize = 0;
+
+        if (IntersectRay(m_nodes[0].Min, m_nodes[0].Max, origin, inverseDirection, maxDistance) < 0.f)
+        {
+            return;
+        }
+
+        stack[stackSize++] = 0;
+        while (stackSize > 0)
+        {
+            Node const& node = m_nodes[stack[--stackSize]];
+            if (node.IsLeaf())
+            {
+                for (uint32_t i = node.LeftOrFirst; i < node.LeftOrFirst + node.Count; ++i)
+                {
+                    float const distance = IntersectRay(m_patchBoxes[i].Min, m_patchBoxes[i].Max, origin, inverseDirection, maxDistance);
+                    if (distance >= 0.f && !visit(m_patchIndices[i], distance))
+                    {
+                        return;
+                    }
+                }
+
+                continue;
+            }
+
+            uint32_t nearChild = node.LeftOrFirst;
+            uint32_t farChild = node.LeftOrFirst + 1;
+            float nearDistance = IntersectRay(m_nodes[nearChild].Min, m_nodes[nearChild].Max, origin, inverseDirection, maxDistance);
+            float farDistance = IntersectRay(m_nodes[farChild].Min, m_nodes[farChild].Max, origin, inverseDirection, maxDistance);
+            if (nearDistance < 0.f || (farDistance >= 0.f && farDistance < nearDistance))
+            {
+                std::swap(nearChild, farChild);
+                std::swap(nearDistance, farDistance);
+            }
+
+            // Far child goes under the near one so the near one is walked first
+            if (farDistance >= 0.f)
+            {
+                stack[stackSize++] = farChild;
+            }
+
+            if (nearDistance >= 0.f)
+            {
+                stack[stackSize++] = nearChild;
+            }
+        }
+    }
+}
\ No newline at end of file
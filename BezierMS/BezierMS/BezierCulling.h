@@ -0,0 +1,270 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <cassert>
+#include <cstdint>
+#include <algorithm>
+
+#include "BezierMaths.h"
+#include "BezierSimd.h"
+#include "BezierBounds.h"
+#include "BezierPatchStore.h"
+
+namespace BezierMaths
+{
+    // Writes the indices of the patches whose bounds aren't outside frustum to visible in ascending order and returns how many there are
+    // visible must have room for bounds.Size entries
+    // Patches are tested Simd::FloatLanes::Width at a time, each plane picks the box corner furthest along its normal once for all lanes
+    inline size_t CullPatches(Frustum const& frustum, Span<PatchBounds const> bounds, uint32_t* visible)
+    {
+        using namespace Simd;
+        constexpr unsigned Width = FloatLanes::Width;
+
+        alignas(CacheLineAlignment) float minimum[3][Width];
+        alignas(CacheLineAlignment) float maximum[3][Width];
+
+        size_t numVisible = 0;
+        for (size_t first = 0; first < bounds.Size; first += Width)
+        {
+            size_t const count = (std::min)(size_t(Width), bounds.Size - first);
+            for (size_t lane = 0; lane < Width; ++lane)
+            {
+                // Unused lanes repeat the last patch, their results are masked off below
+                PatchBounds const& patch = bounds[first + (std::min)(lane, count - 1)];
+                minimum[0][lane] = patch.Min.x;
+                minimum[1][lane] = patch.Min.y;
+                minimum[2][lane] = patch.Min.z;
+                maximum[0][lane] = patch.Max.x;
+                maximum[1][lane] = patch.Max.y;
+                maximum[2][lane] = patch.Max.z;
+            }
+
+            // All bits clear is false in every lane
+            FloatLanes outside = Set1(0.f);
+            for (unsigned side = 0; side < Frustum::NumSides; ++side)
+            {
+                auto const& normal = frustum.Normals[side];
+                FloatLanes const x = Load(normal.x >= 0.f ? maximum[0] : minimum[0]);
+                FloatLanes const y = Load(normal.y >= 0.f ? maximum[1] : minimum[1]);
+                FloatLanes const z = Load(normal.z >= 0.f ? maximum[2] : minimum[2]);
+
+                FloatLanes const distance = x * Set1(normal.x) + y * Set1(normal.y) + z * Set1(normal.z) + Set1(frustum.Distances[side]);
+                outside = Or(outside, Less(distance, Set1(0.f)));
+            }
+
+            uint32_t const visibleBits = ~MaskBits(outside) & ((1u << count) - 1u);
+            for (size_t lane = 0; lane < count; ++lane)
+            {
+                if (visibleBits & (1u << lane))
+                {
+                    visible[numVisible++] = static_cast<uint32_t>(first + lane);
+                }
+            }
+        }
+
+        return numVisible;
+    }
+
+    inline void CullPatches(Frustum const& frustum, Span<PatchBounds const> bounds, std::vector<uint32_t>& visible)
+    {
+        visible.resize(bounds.Size);
+        visible.resize(CullPatches(frustum, bounds, visible.data()));
+    }
+
+    // Cone holding every normal of a patch, normals follow Evaluate so they point along tangent x bitangent
+    // A cone with CosHalfAngle <= 0 spans a half space or more and never rejects anything
+    struct NormalCone
+    {
+        DirectX::SimpleMath::Vector3 Axis;
+        float CosHalfAngle = -1.f;
+        float SinHalfAngle = 0.f;
+    };
+
+    // The tangent and bitangent Evaluate crosses are Bernstein blends of control net edges, a = P(i+1,j,k) - P(i,j+1,k) and
+    // b = P(i,j,k+1) - P(i,j+1,k) over i + j + k = N - 1, so every normal is a non-negative blend of the a x b over all pairs
+    // The cone is centred on the mean of those directions and opened to the widest of them
+    // load(slot) returns control point slot for every lane
+    template<unsigned N, typename LoadPoint>
+    void ComputeNormalConeLanes(LoadPoint const& load, Simd::Vector3Lanes& axis, Simd::FloatLanes& cosHalfAngle)
+    {
+        using namespace Simd;
+        constexpr unsigned NumEdges = BezierTriangle<N - 1>::NumControlPoints;
+
+        Vector3Lanes a[NumEdges], b[NumEdges];
+        unsigned edge = 0;
+        for (unsigned j = 0; j < N; ++j)
+        {
+            for (unsigned k = 0; j + k < N; ++k, ++edge)
+            {
+                // i comes from j and k, TriangularIndex only needs those two
+                Vector3Lanes const p010 = load(TriangularIndex<N>::To1D(j + 1, k));
+                a[edge] = load(TriangularIndex<N>::To1D(j, k)) - p010;
+                b[edge] = load(TriangularIndex<N>::To1D(j, k + 1)) - p010;
+            }
+        }
+
+        FloatLanes const zero = Set1(0.f);
+        Vector3Lanes sum = { zero, zero, zero };
+        for (unsigned m = 0; m < NumEdges; ++m)
+        {
+            for (unsigned n = 0; n < NumEdges; ++n)
+            {
+                sum = sum + Normalize(Cross(a[m], b[n]));
+            }
+        }
+
+        axis = Normalize(sum);
+
+        // Degenerate pairs have no direction and don't widen the cone, a zero axis leaves the cone wide open
+        FloatLanes const one = Set1(1.f);
+        cosHalfAngle = Select(Greater(Dot(axis, axis), zero), one, Set1(-1.f));
+        for (unsigned m = 0; m < NumEdges; ++m)
+        {
+            for (unsigned n = 0; n < NumEdges; ++n)
+            {
+                Vector3Lanes const normal = Normalize(Cross(a[m], b[n]));
+                FloatLanes const cosine = Select(Greater(Dot(normal, normal), zero), Dot(normal, axis), one);
+                cosHalfAngle = Min(cosHalfAngle, cosine);
+            }
+        }
+    }
+
+    template<unsigned N>
+    NormalCone ComputeNormalCone(BezierTriangle<N> const& patch)
+    {
+        using namespace Simd;
+
+        Vector3Lanes axis;
+        FloatLanes cosHalfAngle;
+        ComputeNormalConeLanes<N>([&patch](unsigned slot) -> Vector3Lanes
+        {
+            return { Set1(patch.ControlPoints[slot].x), Set1(patch.ControlPoints[slot].y), Set1(patch.ControlPoints[slot].z) };
+        }, axis, cosHalfAngle);
+
+        alignas(CacheLineAlignment) float lanes[4][FloatLanes::Width];
+        Store(lanes[0], axis.x);
+        Store(lanes[1], axis.y);
+        Store(lanes[2], axis.z);
+        Store(lanes[3], cosHalfAngle);
+
+        NormalCone result;
+        result.Axis = { lanes[0][0], lanes[1][0], lanes[2][0] };
+        result.CosHalfAngle = lanes[3][0];
+        result.SinHalfAngle = std::sqrt((std::max)(0.f, 1.f - result.CosHalfAngle * result.CosHalfAngle));
+        return result;
+    }
+
+    // Cones of FloatLanes::Width patches of a store starting at first, first must be a multiple of the width
+    template<unsigned N>
+    void ComputeNormalCones(BezierPatchStore<N> const& store, size_t first, NormalCone* out)
+    {
+        using namespace Simd;
+        constexpr unsigned Width = FloatLanes::Width;
+
+        Vector3Lanes axis;
+        FloatLanes cosHalfAngle;
+        ComputeNormalConeLanes<N>([&store, first](unsigned slot) { return store.LoadControlPoint(slot, first); }, axis, cosHalfAngle);
+
+        alignas(CacheLineAlignment) float lanes[5][Width];
+        Store(lanes[0], axis.x);
+        Store(lanes[1], axis.y);
+        Store(lanes[2], axis.z);
+        Store(lanes[3], cosHalfAngle);
+        Store(lanes[4], Sqrt(Max(Set1(0.f), Set1(1.f) - cosHalfAngle * cosHalfAngle)));
+
+        size_t const count = (std::min)(size_t(Width), store.GetNumPatches() - first);
+        for (size_t lane = 0; lane < count; ++lane)
+        {
+            out[lane].Axis = { lanes[0][lane], lanes[1][lane], lanes[2][lane] };
+            out[lane].CosHalfAngle = lanes[3][lane];
+            out[lane].SinHalfAngle = lanes[4][lane];
+        }
+    }
+
+    template<unsigned N>
+    void ComputeNormalCones(BezierPatchStore<N> const& store, Span<NormalCone> out)
+    {
+        assert(out.Size >= store.GetNumPatches());
+        for (size_t first = 0; first < store.GetNumPatches(); first += Simd::FloatLanes::Width)
+        {
+            ComputeNormalCones(store, first, &out[first]);
+        }
+    }
+
+    // True when every normal of every point in the bounding sphere faces away from eye
+    // The direction from eye to the sphere varies by asin(r / d) and the normals by the half angle, the patch is back facing when
+    // the two together stay within 90 degrees of the axis: Dot(c - eye, axis) >= sin(halfAngle) * sqrt(d^2 - r^2) + cos(halfAngle) * r
+    inline bool IsBackFacing(NormalCone const& cone, PatchBounds const& bounds, DirectX::SimpleMath::Vector3 const& eye)
+    {
+        DirectX::SimpleMath::Vector3 const toCenter = bounds.Center - eye;
+        float const distanceSquared = toCenter.LengthSquared();
+        float const radiusSquared = bounds.Radius * bounds.Radius;
+
+        return cone.CosHalfAngle > 0.f && distanceSquared > radiusSquared
+            && toCenter.Dot(cone.Axis) >= cone.SinHalfAngle * std::sqrt(distanceSquared - radiusSquared) + cone.CosHalfAngle * bounds.Radius;
+    }
+
+    // Removes back facing patches from a list of patch indices, for example the output of CullPatches, and returns the new count
+    // The order of the remaining indices is kept. Patches are tested Simd::FloatLanes::Width at a time
+    inline size_t CullBackFacing(Span<NormalCone const> cones, Span<PatchBounds const> bounds, DirectX::SimpleMath::Vector3 const& eye, uint32_t* indices, size_t count)
+    {
+        using namespace Simd;
+        constexpr unsigned Width = FloatLanes::Width;
+
+        alignas(CacheLineAlignment) float lanes[9][Width];
+
+        FloatLanes const zero = Set1(0.f);
+        size_t numKept = 0;
+        for (size_t first = 0; first < count; first += Width)
+        {
+            size_t const numLanes = (std::min)(size_t(Width), count - first);
+            for (size_t lane = 0; lane < Width; ++lane)
+            {
+                uint32_t const patch = indices[first + (std::min)(lane, numLanes - 1)];
+                assert(patch < cones.Size && patch < bounds.Size);
+
+                NormalCone const& cone = cones[patch];
+                PatchBounds const& patchBounds = bounds[patch];
+                lanes[0][lane] = patchBounds.Center.x - eye.x;
+                lanes[1][lane] = patchBounds.Center.y - eye.y;
+                lanes[2][lane] = patchBounds.Center.z - eye.z;
+                lanes[3][lane] = patchBounds.Radius;
+                lanes[4][lane] = cone.Axis.x;
+                lanes[5][lane] = cone.Axis.y;
+                lanes[6][lane] = cone.Axis.z;
+                lanes[7][lane] = cone.CosHalfAngle;
+                lanes[8][lane] = cone.SinHalfAngle;
+            }
+
+            Vector3Lanes const toCenter = { Load(lanes[0]), Load(lanes[1]), Load(lanes[2]) };
+            Vector3Lanes const axis = { Load(lanes[4]), Load(lanes[5]), Load(lanes[6]) };
+            FloatLanes const radius = Load(lanes[3]);
+            FloatLanes const cosHalfAngle = Load(lanes[7]);
+
+            FloatLanes const distanceSquared = Dot(toCenter, toCenter);
+            FloatLanes const radiusSquared = radius * radius;
+            FloatLanes const outsideSphere = Greater(distanceSquared, radiusSquared);
+            FloatLanes const tangentDistance = Sqrt(Max(zero, distanceSquared - radiusSquared));
+            FloatLanes const limit = Load(lanes[8]) * tangentDistance + cosHalfAngle * radius;
+
+            FloatLanes const backFacing = And(And(Greater(cosHalfAngle, zero), outsideSphere), GreaterEqual(Dot(toCenter, axis), limit));
+
+            uint32_t const backFacingBits = MaskBits(backFacing);
+            for (size_t lane = 0; lane < numLanes; ++lane)
+            {
+                if (!(backFacingBits & (1u << lane)))
+                {
+                    indices[numKept++] = indices[first + lane];
+                }
+            }
+        }
+
+        return numKept;
+    }
+
+    inline void CullBackFacing(Span<NormalCone const> cones, Span<PatchBounds const> bounds, DirectX::SimpleMath::Vector3 const& eye, std::vector<uint32_t>& indices)
+    {
+        indices.resize(CullBackFacing(cones, bounds, eye, indices.data(), indices.size()));
+    }
+}
\ No newline at end of file
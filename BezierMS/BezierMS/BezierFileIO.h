@@ -1,36 +1,230 @@
 #pragma once
 
 #include <string>
-#include <sstream>
+#include <vector>
+#include <string_view>
+#include <charconv>
 #include <fstream>
 #include <filesystem>
-#include <iomanip>
-#include <exception>
+#include <algorithm>
+#include <stdexcept>
 
 #include "BezierMaths.h"
+#include "BezierTriangleView.h"
 
 namespace BezierFileIO
 {
+    // Parse failure, Line and Column are 1 based and point at the character that couldn't be read
+    class ParseError : public std::runtime_error
+    {
+    public:
+        ParseError(std::string const& message, size_t line, size_t column)
+            : std::runtime_error("Line " + std::to_string(line) + ", column " + std::to_string(column) + ": " + message), Line(line), Column(column)
+        {}
+
+        size_t Line;
+        size_t Column;
+    };
+
+    // Single pass reader over the .bez text syntax, a patch is {{ followed by control points {x f, y f, z f} separated by commas and }}
+    // The trailing f and the comma after the last control point are optional, whitespace is allowed between any two tokens
+    // Floats are read with std::from_chars straight out of the buffer, line and column are only worked out when reporting an error
+    class TextParser
+    {
+    public:
+        // firstLine and firstColumn place text inside a larger file for error reports
+        explicit TextParser(std::string_view text, size_t firstLine = 1, size_t firstColumn = 1)
+            : m_begin(text.data()), m_current(text.data()), m_end(text.data() + text.size()), m_firstLine(firstLine), m_firstColumn(firstColumn)
+        {}
+
+        // True once only whitespace is left
+        bool AtEnd()
+        {
+            SkipWhitespace();
+            return m_current == m_end;
+        }
+
+        bool Accept(char c)
+        {
+            SkipWhitespace();
+            if (m_current != m_end && *m_current == c)
+            {
+                ++m_current;
+                return true;
+            }
+
+            return false;
+        }
+
+        void Expect(char c)
+        {
+            if (!Accept(c))
+            {
+                Fail(std::string("expected '") + c + "'");
+            }
+        }
+
+        float ParseFloat()
+        {
+            SkipWhitespace();
+
+            // from_chars doesn't take a leading plus, skip it only in front of the digits so "+-1" and "+ 1" still fail
+            if (m_current != m_end && *m_current == '+')
+            {
+                char const next = m_current + 1 != m_end ? m_current[1] : '\0';
+                if (!(next >= '0' && next <= '9') && next != '.')
+                {
+                    Fail("expected a number");
+                }
+
+                ++m_current;
+            }
+
+            float value = 0.f;
+            auto const result = std::from_chars(m_current, m_end, value);
+            if (result.ec != std::errc())
+            {
+                Fail(result.ec == std::errc::result_out_of_range ? "number out of range" : "expected a number");
+            }
+
+            m_current = result.ptr;
+            if (m_current != m_end && (*m_current == 'f' || *m_current == 'F'))
+            {
+                ++m_current;
+            }
+
+            return value;
+        }
+
+        BezierMaths::ControlPoint ParseControlPoint()
+        {
+            BezierMaths::ControlPoint point;
+            Expect('{');
+            point.x = ParseFloat();
+            Expect(',');
+            point.y = ParseFloat();
+            Expect(',');
+            point.z = ParseFloat();
+            Expect('}');
+            return point;
+        }
+
+        // Reads one patch and calls visit(controlPoint) for each of its control points in file order, returns how many there were
+        template<typename Visitor>
+        size_t ParsePatch(Visitor&& visit)
+        {
+            Expect('{');
+            Expect('{');
+
+            size_t count = 0;
+            while (!Accept('}'))
+            {
+                visit(ParseControlPoint());
+                ++count;
+
+                if (!Accept(','))
+                {
+                    Expect('}');
+                    break;
+                }
+            }
+
+            Expect('}');
+            return count;
+        }
+
+        size_t GetOffset() const { return static_cast<size_t>(m_current - m_begin); }
+
+        [[noreturn]] void Fail(std::string const& message) const
+        {
+            size_t line = m_firstLine;
+            size_t column = m_firstColumn;
+            for (char const* c = m_begin; c != m_current; ++c)
+            {
+                column = *c == '\n' ? 1 : column + 1;
+                line += *c == '\n' ? 1 : 0;
+            }
+
+            throw ParseError(message, line, column);
+        }
+
+    private:
+        void SkipWhitespace()
+        {
+            while (m_current != m_end && (*m_current == ' ' || *m_current == '\n' || *m_current == '\r' || *m_current == '\t'))
+            {
+                ++m_current;
+            }
+        }
+
+        char const* m_begin;
+        char const* m_current;
+        char const* m_end;
+        size_t m_firstLine;
+        size_t m_firstColumn;
+    };
+
+    // Whole file in one read
+    inline std::string ReadTextFile(std::wstring const& filePath)
+    {
+        std::ifstream file(std::filesystem::path(filePath), std::ios::binary);
+        if (!file)
+        {
+            throw std::runtime_error("Couldn't open " + std::filesystem::path(filePath).string() + ".");
+        }
+
+        file.seekg(0, std::ios::end);
+        std::streamoff const size = file.tellg();
+        if (size < 0)
+        {
+            throw std::runtime_error("Couldn't get the size of " + std::filesystem::path(filePath).string() + ".");
+        }
+
+        std::string contents(static_cast<size_t>(size), '\0');
+        file.seekg(0, std::ios::beg);
+        file.read(contents.data(), contents.size());
+        if (static_cast<size_t>(file.gcount()) != contents.size())
+        {
+            throw std::runtime_error("Couldn't read all of " + std::filesystem::path(filePath).string() + ".");
+        }
+
+        return contents;
+    }
+
+    // Reads the next patch from parser, it has to have exactly the control points of a degree N patch
     template<unsigned N>
-    BezierMaths::BezierTriangle<N> ParsePatch(std::string& inputString)
+    BezierMaths::BezierTriangle<N> ParsePatch(TextParser& parser)
     {
-        std::stringstream stream(inputString);
         BezierMaths::BezierTriangle<N> ret;
-        std::string str;
 
-        std::getline(stream, str, '{');
-        std::getline(stream, str, '{');
+        size_t count = 0;
+        parser.ParsePatch([&](BezierMaths::ControlPoint const& point)
+        {
+            if (count == BezierMaths::BezierTriangle<N>::NumControlPoints)
+            {
+                parser.Fail("more than " + std::to_string(count) + " control points for a degree " + std::to_string(N) + " patch");
+            }
+
+            ret.ControlPoints[count++] = point;
+        });
 
-        for (int i = 0; i < BezierMaths::BezierTriangle<N>::NumControlPoints; ++i)
+        if (count != BezierMaths::BezierTriangle<N>::NumControlPoints)
         {
-            std::getline(stream, str, '{');
-            char floatChar;
-            char separator;
-            float x, y, z;
-            stream >> x >> floatChar >> separator >> y >> floatChar >> separator >> z;
-            std::getline(stream, str, '}');
+            parser.Fail(std::to_string(count) + " control points for a degree " + std::to_string(N) + " patch");
+        }
+
+        return ret;
+    }
 
-            ret.ControlPoints[i] = { x, y, z };
+    template<unsigned N>
+    BezierMaths::BezierTriangle<N> ParsePatch(std::string_view inputString)
+    {
+        TextParser parser(inputString);
+        BezierMaths::BezierTriangle<N> const ret = ParsePatch<N>(parser);
+
+        if (!parser.AtEnd())
+        {
+            parser.Fail("unexpected text after the patch");
         }
 
         return ret;
@@ -39,71 +233,194 @@ namespace BezierFileIO
     template<unsigned N>
     BezierMaths::BezierTriangle<N> ReadFromFile(std::wstring const& filePath)
     {
-        std::ifstream file;
-        file.open(filePath);
+        return ParsePatch<N>(ReadTextFile(filePath));
+    }
 
-        std::string fileContents;
-        std::string line;
+    // Reads every control point in the string, the degree follows from how many there are
+    inline BezierMaths::DynamicBezierTriangle ParseDynamicPatch(std::string_view inputString)
+    {
+        TextParser parser(inputString);
+        BezierMaths::DynamicBezierTriangle ret;
+
+        parser.ParsePatch([&](BezierMaths::ControlPoint const& point) { ret.ControlPoints.push_back(point); });
+
+        ret.Degree = BezierMaths::DegreeFromNumControlPoints(ret.ControlPoints.size());
+        if (ret.Degree == 0)
+        {
+            parser.Fail(std::to_string(ret.ControlPoints.size()) + " control points don't form a Bezier triangle");
+        }
 
-        while (file >> line)
+        if (!parser.AtEnd())
         {
-            fileContents += line;
+            parser.Fail("unexpected text after the patch");
         }
 
-        fileContents.erase(remove_if(fileContents.begin(), fileContents.end(), isspace), fileContents.end());
+        return ret;
+    }
 
-        return ParsePatch<N>(fileContents);
+    // Counterpart of ReadFromFile<N> for files whose degree isn't known at compile time
+    inline BezierMaths::DynamicBezierTriangle ReadAnyDegreeFromFile(std::wstring const& filePath)
+    {
+        return ParseDynamicPatch(ReadTextFile(filePath));
     }
 
-    template<unsigned N>
-    void WriteToFile(std::wstring const& filePath, BezierMaths::BezierTriangle<N> const& patch)
+    // Buffered writer for the .bez text syntax, floats are formatted with std::to_chars into one reusable buffer that goes out in big writes
+    // Patches are written one after another, so a file with several of them is a scene
+    class PatchTextWriter
     {
-        if (std::filesystem::exists(std::filesystem::path(filePath)))
+    public:
+        // precision is the number of decimals, negative for the shortest text that reads back to the same float
+        // Throws if the file already exists
+        explicit PatchTextWriter(std::wstring const& filePath, int precision = -1, size_t bufferSize = size_t(1) << 20)
+            : m_precision(precision)
         {
-            std::wstringstream errorStream;
-            errorStream << "File " << filePath << " already exists.";
-            throw std::runtime_error(errorStream.str());
+            if (std::filesystem::exists(std::filesystem::path(filePath)))
+            {
+                throw std::runtime_error("File " + std::filesystem::path(filePath).string() + " already exists.");
+            }
+
+            m_file.open(std::filesystem::path(filePath), std::ios::binary);
+            if (!m_file)
+            {
+                throw std::runtime_error("Couldn't create " + std::filesystem::path(filePath).string() + ".");
+            }
+
+            m_buffer.resize((std::max)(bufferSize, MinBufferSize));
         }
 
-        std::ofstream file(filePath);
-        file << "{{\n";
+        // Errors while flushing here are lost, call Close to see them
+        ~PatchTextWriter()
+        {
+            if (m_file.is_open())
+            {
+                m_file.write(m_buffer.data(), static_cast<std::streamsize>(m_used));
+            }
+        }
 
-        char const floatChar = 'f';
-        std::string const separator = ", ";
+        PatchTextWriter(PatchTextWriter const&) = delete;
+        PatchTextWriter& operator=(PatchTextWriter const&) = delete;
 
-        float const temp = (sqrt(patch.NumControlPoints * 8.f + 1.f) - 1.f) / 2.0f - 0.000001f;
-        unsigned const NumRows = static_cast<unsigned int>(BezierMaths::ceil(temp));
+        // Rows of the patch on their own lines, the row count comes from the degree
+        void Write(BezierMaths::BezierTriangleView const& patch)
+        {
+            Append("{{\n");
+            for (unsigned row = 0; row <= patch.Degree; ++row)
+            {
+                for (unsigned i = 0; i <= row; ++i)
+                {
+                    BezierMaths::ControlPoint const& ctrlPoint = patch.ControlPoints[(row * (row + 1)) / 2 + i];
+
+                    Append("{");
+                    AppendFloat(ctrlPoint.x);
+                    Append("f, ");
+                    AppendFloat(ctrlPoint.y);
+                    Append("f, ");
+                    AppendFloat(ctrlPoint.z);
+                    Append("f}");
+
+                    // Comma and space inside a row, only a comma at the end of one and nothing after the last control point
+                    if (i < row)
+                    {
+                        Append(", ");
+                    }
+                    else if (row < patch.Degree)
+                    {
+                        Append(",");
+                    }
+                }
+
+                Append("\n");
+            }
+
+            Append("}}\n");
+        }
+
+        template<unsigned N>
+        void Write(BezierMaths::BezierTriangle<N> const& patch)
+        {
+            Write(BezierMaths::BezierTriangleView(patch));
+        }
 
-        for (unsigned row = 0; row < NumRows; ++row)
+        template<unsigned N, unsigned M>
+        void Write(BezierMaths::BezierShape<N, M> const& shape)
         {
-            for (unsigned i = 0; i < row + 1; ++i)
+            for (auto const& patch : shape.Patches)
             {
-                BezierMaths::ControlPoint const & ctrlPoint = patch.ControlPoints[(row * (row + 1)) / 2 + i];
-                file << "{" << std::fixed << std::setprecision(4) << ctrlPoint.x << floatChar << separator << ctrlPoint.y << floatChar << separator << ctrlPoint.z << floatChar << "}";
+                Write(patch);
+            }
+        }
 
-                std::string delimeter = separator;
+        // Writes what is buffered, throws if the file can't take it
+        void Flush()
+        {
+            m_file.write(m_buffer.data(), static_cast<std::streamsize>(m_used));
+            m_used = 0;
+            if (!m_file)
+            {
+                throw std::runtime_error("Couldn't write a patch file.");
+            }
+        }
 
-                // Only comma for the last control point of the row
-                if (i == row)
+        void Close()
+        {
+            Flush();
+            m_file.close();
+        }
+
+    private:
+        // Room for any float to_chars can produce at a sensible precision
+        static constexpr size_t MinBufferSize = 4096;
+
+        void Reserve(size_t size)
+        {
+            if (m_buffer.size() - m_used < size)
+            {
+                Flush();
+            }
+        }
+
+        void Append(std::string_view text)
+        {
+            Reserve(text.size());
+            std::copy(text.begin(), text.end(), m_buffer.data() + m_used);
+            m_used += text.size();
+        }
+
+        void AppendFloat(float value)
+        {
+            // A float that doesn't fit in what is left of the buffer is formatted again into an empty one
+            for (bool const retry : { false, true })
+            {
+                char* const first = m_buffer.data() + m_used;
+                char* const last = m_buffer.data() + m_buffer.size();
+                auto const result = m_precision < 0 ? std::to_chars(first, last, value) : std::to_chars(first, last, value, std::chars_format::fixed, m_precision);
+                if (result.ec == std::errc())
                 {
-                    delimeter = ",";
+                    m_used = static_cast<size_t>(result.ptr - m_buffer.data());
+                    return;
                 }
 
-                // No delimiter for the last control point of the patch
-                if (i == 3)
+                if (retry)
                 {
-                    delimeter = "";
+                    throw std::runtime_error("Couldn't format " + std::to_string(value) + ".");
                 }
 
-                file << delimeter;
+                Flush();
             }
-
-            // New line per row
-            file << "\n";
         }
 
-        file << "}}";
+        std::ofstream m_file;
+        std::vector<char> m_buffer;
+        size_t m_used = 0;
+        int m_precision;
+    };
 
-        file.close();
+    // Single patch in the format ReadFromFile reads, with four decimals like earlier versions wrote
+    template<unsigned N>
+    void WriteToFile(std::wstring const& filePath, BezierMaths::BezierTriangle<N> const& patch)
+    {
+        PatchTextWriter writer(filePath, 4);
+        writer.Write(patch);
+        writer.Close();
     }
 }
\ No newline at end of file
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <limits>
+#include <cassert>
+#include <cstdint>
+#include <algorithm>
+
+#include "BezierMaths.h"
+#include "BezierPatchStore.h"
+#include "BezierTessellation.h"
+#include "ThreadPool.h"
+
+namespace BezierMaths
+{
+    struct ByteRange
+    {
+        size_t Offset = 0;
+        size_t Size = 0;
+    };
+
+    // Indexed tessellation of a whole store that only re-tessellates the patches edited since the last Update
+    // Patch p owns vertices [p * V, (p + 1) * V) and indices [p * I, (p + 1) * I) of the shared buffers, so an edit rewrites its slice in place
+    // Changed bytes are collected until ClearDirtyRanges, adjacent patches are merged into one range so an upload is a handful of copies
+    template<unsigned N, typename Index = uint32_t>
+    class IncrementalTessellation
+    {
+    public:
+        // Throws like the other tessellation entry points if options.NumRows is 0
+        explicit IncrementalTessellation(TessellationOptions const& options = {})
+            : m_numRows(options.NumRows), m_basis(GetBernsteinBasis<N>(options.NumRows))
+        {}
+
+        unsigned GetNumRows() const { return m_numRows; }
+        size_t GetNumVerticesPerPatch() const { return m_basis->NumVertices; }
+        size_t GetNumIndicesPerPatch() const { return size_t(m_numRows) * m_numRows * 3; }
+
+        // Brings the buffers up to date with store, returns the number of patches that were re-tessellated
+        // Patches are compared by GetPatchVersion, patches added since the last call are always tessellated
+        size_t Update(BezierPatchStore<N> const& store, ThreadPool* pool = nullptr)
+        {
+            size_t const numPatches = store.GetNumPatches();
+            size_t const oldNumPatches = m_versions.size();
+            size_t const verticesPerPatch = GetNumVerticesPerPatch();
+            size_t const indicesPerPatch = GetNumIndicesPerPatch();
+            assert(numPatches * verticesPerPatch - (numPatches > 0 ? 1 : 0) <= (std::numeric_limits<Index>::max)());
+
+            m_vertices.resize(numPatches * verticesPerPatch);
+            m_indices.resize(numPatches * indicesPerPatch);
+            m_versions.resize(numPatches);
+            m_vertexDirty.resize(numPatches, false);
+            m_indexDirty.resize(numPatches, false);
+
+            // Index slices only depend on the slot, they are written once when a patch first shows up
+            for (size_t patch = oldNumPatches; patch < numPatches; ++patch)
+            {
+                WriteGridIndices<Index>(m_numRows, static_cast<Index>(patch * verticesPerPatch), &m_indices[patch * indicesPerPatch]);
+                m_indexDirty[patch] = true;
+            }
+
+            std::vector<uint32_t> edited;
+            for (size_t patch = 0; patch < numPatches; ++patch)
+            {
+                uint64_t const version = store.GetPatchVersion(patch);
+                if (patch >= oldNumPatches || version != m_versions[patch])
+                {
+                    m_versions[patch] = version;
+                    m_vertexDirty[patch] = true;
+                    edited.push_back(static_cast<uint32_t>(patch));
+                }
+            }
+
+            auto const tessellate = [&](size_t begin, size_t end)
+            {
+                DispatchRowCount(m_numRows, [&](auto rows)
+                {
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        EvaluateGrid<N, decltype(rows)::value>(store.Get(edited[i]), *m_basis, &m_vertices[edited[i] * verticesPerPatch]);
+                    }
+                });
+            };
+
+            if (pool)
+            {
+                // Same grain as TessellateShapeParallel, a few thousand triangles per task
+                pool->ParallelFor(edited.size(), (std::max)(size_t(1), size_t(4096) / (size_t(m_numRows) * m_numRows)), tessellate);
+            }
+            else
+            {
+                tessellate(0, edited.size());
+            }
+
+            m_dirtyVertexRanges = GetRanges(m_vertexDirty, verticesPerPatch * sizeof(Vertex));
+            m_dirtyIndexRanges = GetRanges(m_indexDirty, indicesPerPatch * sizeof(Index));
+
+            return edited.size();
+        }
+
+        // Retessellates every patch on the next Update
+        void Invalidate()
+        {
+            m_versions.clear();
+            m_vertices.clear();
+            m_indices.clear();
+            m_vertexDirty.clear();
+            m_indexDirty.clear();
+            m_dirtyVertexRanges.clear();
+            m_dirtyIndexRanges.clear();
+        }
+
+        // Call once the dirty ranges have been uploaded
+        void ClearDirtyRanges()
+        {
+            std::fill(m_vertexDirty.begin(), m_vertexDirty.end(), false);
+            std::fill(m_indexDirty.begin(), m_indexDirty.end(), false);
+            m_dirtyVertexRanges.clear();
+            m_dirtyIndexRanges.clear();
+        }
+
+        Span<Vertex const> GetVertices() const { return { m_vertices.data(), m_vertices.size() }; }
+        Span<Index const> GetIndices() const { return { m_indices.data(), m_indices.size() }; }
+
+        // Byte ranges of GetVertices and GetIndices changed since the last ClearDirtyRanges, in increasing order
+        Span<ByteRange const> GetDirtyVertexRanges() const { return { m_dirtyVertexRanges.data(), m_dirtyVertexRanges.size() }; }
+        Span<ByteRange const> GetDirtyIndexRanges() const { return { m_dirtyIndexRanges.data(), m_dirtyIndexRanges.size() }; }
+
+    private:
+        static std::vector<ByteRange> GetRanges(std::vector<bool> const& dirty, size_t bytesPerPatch)
+        {
+            std::vector<ByteRange> ranges;
+            for (size_t patch = 0; patch < dirty.size(); ++patch)
+            {
+                if (!dirty[patch])
+                {
+                    continue;
+                }
+
+                if (!ranges.empty() && ranges.back().Offset + ranges.back().Size == patch * bytesPerPatch)
+                {
+                    ranges.back().Size += bytesPerPatch;
+                }
+                else
+                {
+                    ranges.push_back({ patch * bytesPerPatch, bytesPerPatch });
+                }
+            }
+
+            return ranges;
+        }
+
+        unsigned m_numRows;
+        std::shared_ptr<BernsteinBasis const> m_basis;
+
+        std::vector<Vertex> m_vertices;
+        std::vector<Index> m_indices;
+
+        // Store version each patch was last tessellated at
+        std::vector<uint64_t> m_versions;
+
+        std::vector<bool> m_vertexDirty;
+        std::vector<bool> m_indexDirty;
+        std::vector<ByteRange> m_dirtyVertexRanges;
+        std::vector<ByteRange> m_dirtyIndexRanges;
+    };
+}
\ No newline at end of file
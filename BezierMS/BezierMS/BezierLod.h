@@ -0,0 +1,152 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <cassert>
+#include <cstdint>
+#include <algorithm>
+
+#include "BezierMaths.h"
+#include "BezierSimd.h"
+#include "BezierBounds.h"
+#include "BezierPatchStore.h"
+
+namespace BezierMaths
+{
+    // Largest distance of a control point from the flat triangle through the corners, at the same barycentric spot
+    // Bernstein polynomials reproduce linear functions, so the patch strays from the corner triangle by at most this much
+    template<unsigned N>
+    float ComputeFlatness(BezierTriangle<N> const& patch)
+    {
+        ControlPoint const& cornerI = patch.ControlPoints[TriangularIndex<N>::To1D(0, 0)];
+        ControlPoint const& cornerJ = patch.ControlPoints[TriangularIndex<N>::To1D(N, 0)];
+        ControlPoint const& cornerK = patch.ControlPoints[TriangularIndex<N>::To1D(0, N)];
+
+        float deviationSquared = 0.f;
+        for (unsigned j = 0; j <= N; ++j)
+        {
+            for (unsigned k = 0; j + k <= N; ++k)
+            {
+                unsigned const i = N - j - k;
+                ControlPoint const flat = (cornerI * float(i) + cornerJ * float(j) + cornerK * float(k)) / float(N);
+                deviationSquared = (std::max)(deviationSquared, (patch.ControlPoints[TriangularIndex<N>::To1D(j, k)] - flat).LengthSquared());
+            }
+        }
+
+        return std::sqrt(deviationSquared);
+    }
+
+    // Flatness of every patch of a store, FloatLanes::Width patches at a time
+    template<unsigned N>
+    void ComputeFlatness(BezierPatchStore<N> const& store, Span<float> out)
+    {
+        using namespace Simd;
+        constexpr unsigned Width = FloatLanes::Width;
+        assert(out.Size >= store.GetNumPatches());
+
+        FloatLanes const inverseDegree = Set1(1.f / N);
+        for (size_t first = 0; first < store.GetNumPatches(); first += Width)
+        {
+            Vector3Lanes const cornerI = store.LoadControlPoint(TriangularIndex<N>::To1D(0, 0), first);
+            Vector3Lanes const cornerJ = store.LoadControlPoint(TriangularIndex<N>::To1D(N, 0), first);
+            Vector3Lanes const cornerK = store.LoadControlPoint(TriangularIndex<N>::To1D(0, N), first);
+
+            FloatLanes deviationSquared = Set1(0.f);
+            for (unsigned j = 0; j <= N; ++j)
+            {
+                for (unsigned k = 0; j + k <= N; ++k)
+                {
+                    unsigned const i = N - j - k;
+                    Vector3Lanes const flat = (cornerI * Set1(float(i)) + cornerJ * Set1(float(j)) + cornerK * Set1(float(k))) * inverseDegree;
+                    Vector3Lanes const offset = store.LoadControlPoint(TriangularIndex<N>::To1D(j, k), first) - flat;
+                    deviationSquared = Max(deviationSquared, Dot(offset, offset));
+                }
+            }
+
+            alignas(CacheLineAlignment) float lanes[Width];
+            Store(lanes, Sqrt(deviationSquared));
+            std::copy_n(lanes, (std::min)(size_t(Width), store.GetNumPatches() - first), &out[first]);
+        }
+    }
+
+    // Camera terms for screen space error
+    struct LodView
+    {
+        DirectX::SimpleMath::Vector3 Eye;
+
+        // Pixels covered by one unit of length one unit in front of the camera
+        float PixelsPerUnit = 1.f;
+
+        // projection is a D3D style row vector perspective matrix
+        static LodView FromProjection(DirectX::SimpleMath::Vector3 const& eye, DirectX::SimpleMath::Matrix const& projection, float viewportHeight)
+        {
+            return { eye, projection.m[1][1] * viewportHeight * 0.5f };
+        }
+    };
+
+    struct LodOptions
+    {
+        // Screen space distance allowed between the surface and its triangles
+        float MaxErrorPixels = 0.5f;
+
+        // Caps the on screen length of a row when non zero, so large flat patches still get enough vertices for smooth shading
+        float MaxRowPixels = 0.f;
+
+        unsigned MinRows = 1;
+        unsigned MaxRows = 64;
+    };
+
+    // Row counts for the uniform tessellation of each patch, Simd::FloatLanes::Width patches at a time
+    // The patch is taken to be as close as the nearest point of its bounding sphere, a camera inside the sphere gets MaxRows
+    // A grid of R rows cuts the deviation of a patch from its triangles by about R^2, so R = sqrt(projected flatness / MaxErrorPixels)
+    inline void ComputeTessellationRows(LodView const& view, Span<PatchBounds const> bounds, Span<float const> flatness, LodOptions const& options, Span<unsigned> rows)
+    {
+        using namespace Simd;
+        constexpr unsigned Width = FloatLanes::Width;
+        assert(flatness.Size >= bounds.Size && rows.Size >= bounds.Size);
+        assert(options.MinRows >= 1 && options.MinRows <= options.MaxRows);
+
+        FloatLanes const pixelsPerUnit = Set1(view.PixelsPerUnit);
+        FloatLanes const inverseMaxError = Set1(1.f / options.MaxErrorPixels);
+        FloatLanes const inverseMaxRowPixels = Set1(options.MaxRowPixels > 0.f ? 1.f / options.MaxRowPixels : 0.f);
+        FloatLanes const maxRows = Set1(float(options.MaxRows));
+
+        alignas(CacheLineAlignment) float lanes[5][Width];
+        for (size_t first = 0; first < bounds.Size; first += Width)
+        {
+            size_t const count = (std::min)(size_t(Width), bounds.Size - first);
+            for (size_t lane = 0; lane < Width; ++lane)
+            {
+                size_t const patch = first + (std::min)(lane, count - 1);
+                lanes[0][lane] = bounds[patch].Center.x - view.Eye.x;
+                lanes[1][lane] = bounds[patch].Center.y - view.Eye.y;
+                lanes[2][lane] = bounds[patch].Center.z - view.Eye.z;
+                lanes[3][lane] = bounds[patch].Radius;
+                lanes[4][lane] = flatness[patch];
+            }
+
+            Vector3Lanes const toCenter = { Load(lanes[0]), Load(lanes[1]), Load(lanes[2]) };
+            FloatLanes const radius = Load(lanes[3]);
+            FloatLanes const distance = Sqrt(Dot(toCenter, toCenter)) - radius;
+            FloatLanes const inside = Less(distance, Set1(1e-6f));
+            FloatLanes const scale = pixelsPerUnit / Max(distance, Set1(1e-6f));
+
+            FloatLanes const errorRows = Sqrt(Load(lanes[4]) * scale * inverseMaxError);
+            FloatLanes const sizeRows = radius * Set1(2.f) * scale * inverseMaxRowPixels;
+
+            Store(lanes[0], Select(inside, maxRows, Min(Max(errorRows, sizeRows), maxRows)));
+
+            // SSE2 has no rounding instruction, rounding up a handful of lanes isn't worth emulating it
+            for (size_t lane = 0; lane < count; ++lane)
+            {
+                rows[first + lane] = (std::max)(options.MinRows, static_cast<unsigned>(std::ceil(lanes[0][lane])));
+            }
+        }
+    }
+
+    inline void ComputeTessellationRows(LodView const& view, Span<PatchBounds const> bounds, Span<float const> flatness, LodOptions const& options, std::vector<unsigned>& rows)
+    {
+        rows.resize(bounds.Size);
+        ComputeTessellationRows(view, bounds, flatness, options, Span<unsigned>(rows.data(), rows.size()));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,313 @@
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <memory>
+#include <cstdint>
+#include <algorithm>
+#include <unordered_map>
+#include <condition_variable>
+
+#include "BezierMaths.h"
+#include "BezierPatchStore.h"
+#include "BezierTessellation.h"
+#include "ThreadPool.h"
+
+namespace BezierMaths
+{
+    // Indexed meshes of store patches at power of two row counts, least recently used entries are dropped once the budget is exceeded
+    // Entries remember the patch version they were built from, editing a patch makes its old meshes misses
+    // Meshes are handed out as shared pointers, so evicting an entry never frees a mesh that is still being drawn
+    template<unsigned N, typename Index = uint32_t>
+    class PatchLodCache
+    {
+    public:
+        using Mesh = IndexedMesh<Index>;
+        using MeshPtr = std::shared_ptr<Mesh const>;
+
+        // Level L is tessellated with 2^L rows
+        static constexpr unsigned MaxLevel = 6;
+
+        struct Statistics
+        {
+            size_t Hits = 0;
+            size_t Misses = 0;
+            size_t Evictions = 0;
+        };
+
+        // Builds for Request run on pool, without a pool Request builds on the calling thread like Get
+        explicit PatchLodCache(size_t budgetBytes, ThreadPool* pool = &ThreadPool::GetDefault())
+            : m_budgetBytes(budgetBytes), m_pool(pool)
+        {}
+
+        // Waits for queued builds, they hold a pointer to the cache
+        ~PatchLodCache()
+        {
+            WaitIdle();
+        }
+
+        PatchLodCache(PatchLodCache const&) = delete;
+        PatchLodCache& operator=(PatchLodCache const&) = delete;
+
+        // Smallest level with at least numRows rows
+        static unsigned GetLevel(unsigned numRows)
+        {
+            unsigned level = 0;
+            while (level < MaxLevel && (1u << level) < numRows)
+            {
+                ++level;
+            }
+
+            return level;
+        }
+
+        static unsigned GetNumRows(unsigned level) { return 1u << level; }
+
+        // Mesh for the level covering numRows, nullptr on a miss
+        // A miss queues a build of that level and returns the closest current level of the same patch if there is one, finer levels first
+        MeshPtr Request(BezierPatchStore<N> const& store, uint32_t patch, unsigned numRows)
+        {
+            if (!m_pool)
+            {
+                return Get(store, patch, numRows);
+            }
+
+            unsigned const level = GetLevel(numRows);
+            uint64_t const version = store.GetPatchVersion(patch);
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (MeshPtr mesh = FindLocked(patch, level, version))
+                {
+                    ++m_statistics.Hits;
+                    return mesh;
+                }
+
+                ++m_statistics.Misses;
+
+                // A build still running for an older version of the patch doesn't hold back the one for this version
+                auto const pending = m_pending.find(GetKey(patch, level));
+                if (pending != m_pending.end() && pending->second >= version)
+                {
+                    return FindClosestLocked(patch, level, version);
+                }
+
+                m_pending[GetKey(patch, level)] = version;
+                ++m_numBuilding;
+            }
+
+            // The patch is copied now, the store may change before the build runs
+            // A throwing build still finishes, otherwise WaitIdle and the destructor would wait for it forever
+            auto build = [this, patch, level, version, controlPoints = store.Get(patch)]()
+            {
+                try
+                {
+                    Insert(patch, level, version, Build(controlPoints, level));
+                }
+                catch (...)
+                {
+                    FinishBuild(patch, level, version);
+                    throw;
+                }
+
+                FinishBuild(patch, level, version);
+            };
+
+            m_pool->Submit(std::move(build));
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return FindClosestLocked(patch, level, version);
+        }
+
+        // Mesh for the level covering numRows, built on the calling thread on a miss
+        MeshPtr Get(BezierPatchStore<N> const& store, uint32_t patch, unsigned numRows)
+        {
+            unsigned const level = GetLevel(numRows);
+            uint64_t const version = store.GetPatchVersion(patch);
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (MeshPtr mesh = FindLocked(patch, level, version))
+                {
+                    ++m_statistics.Hits;
+                    return mesh;
+                }
+
+                ++m_statistics.Misses;
+            }
+
+            MeshPtr mesh = Build(store.Get(patch), level);
+            Insert(patch, level, version, mesh);
+            return mesh;
+        }
+
+        // Blocks until every queued build is in the cache
+        void WaitIdle()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_idleCondition.wait(lock, [this]() { return m_numBuilding == 0; });
+        }
+
+        void SetBudget(size_t budgetBytes)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_budgetBytes = budgetBytes;
+            EvictLocked();
+        }
+
+        void Clear()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_entries.clear();
+            m_recentlyUsed.clear();
+            m_usedBytes = 0;
+        }
+
+        size_t GetBudget() const { std::lock_guard<std::mutex> lock(m_mutex); return m_budgetBytes; }
+        size_t GetUsedBytes() const { std::lock_guard<std::mutex> lock(m_mutex); return m_usedBytes; }
+        size_t GetNumEntries() const { std::lock_guard<std::mutex> lock(m_mutex); return m_entries.size(); }
+        Statistics GetStatistics() const { std::lock_guard<std::mutex> lock(m_mutex); return m_statistics; }
+
+        // Bytes an entry is charged for
+        static size_t GetMeshBytes(Mesh const& mesh)
+        {
+            return sizeof(Mesh) + mesh.Vertices.capacity() * sizeof(Vertex) + mesh.Indices.capacity() * sizeof(Index);
+        }
+
+    private:
+        struct Entry
+        {
+            MeshPtr Mesh;
+            uint64_t Version = 0;
+            size_t Bytes = 0;
+            typename std::list<uint64_t>::iterator RecentlyUsed;
+        };
+
+        static uint64_t GetKey(uint32_t patch, unsigned level) { return (uint64_t(patch) << 8) | level; }
+
+        static MeshPtr Build(BezierTriangle<N> const& patch, unsigned level)
+        {
+            return std::make_shared<Mesh const>(TessellatePatchIndexed<N, Index>(patch, { GetNumRows(level) }));
+        }
+
+        void FinishBuild(uint32_t patch, unsigned level, uint64_t version)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            // Leaves the entry of a newer version queued while this build ran
+            auto const pending = m_pending.find(GetKey(patch, level));
+            if (pending != m_pending.end() && pending->second == version)
+            {
+                m_pending.erase(pending);
+            }
+
+            if (--m_numBuilding == 0)
+            {
+                m_idleCondition.notify_all();
+            }
+        }
+
+        void Insert(uint32_t patch, unsigned level, uint64_t version, MeshPtr mesh)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            uint64_t const key = GetKey(patch, level);
+
+            auto found = m_entries.find(key);
+            if (found != m_entries.end())
+            {
+                // A build from an older version finishing late doesn't replace a newer mesh
+                if (found->second.Version > version)
+                {
+                    return;
+                }
+
+                EraseLocked(found);
+            }
+
+            Entry entry;
+            entry.Mesh = std::move(mesh);
+            entry.Version = version;
+            entry.Bytes = GetMeshBytes(*entry.Mesh);
+            m_recentlyUsed.push_front(key);
+            entry.RecentlyUsed = m_recentlyUsed.begin();
+
+            m_usedBytes += entry.Bytes;
+            m_entries.emplace(key, std::move(entry));
+            EvictLocked();
+        }
+
+        MeshPtr FindLocked(uint32_t patch, unsigned level, uint64_t version)
+        {
+            auto found = m_entries.find(GetKey(patch, level));
+            if (found == m_entries.end())
+            {
+                return nullptr;
+            }
+
+            if (found->second.Version != version)
+            {
+                EraseLocked(found);
+                return nullptr;
+            }
+
+            m_recentlyUsed.splice(m_recentlyUsed.begin(), m_recentlyUsed, found->second.RecentlyUsed);
+            return found->second.Mesh;
+        }
+
+        MeshPtr FindClosestLocked(uint32_t patch, unsigned level, uint64_t version)
+        {
+            for (unsigned distance = 1; distance <= MaxLevel; ++distance)
+            {
+                if (level + distance <= MaxLevel)
+                {
+                    if (MeshPtr mesh = FindLocked(patch, level + distance, version))
+                    {
+                        return mesh;
+                    }
+                }
+
+                if (level >= distance)
+                {
+                    if (MeshPtr mesh = FindLocked(patch, level - distance, version))
+                    {
+                        return mesh;
+                    }
+                }
+            }
+
+            return nullptr;
+        }
+
+        void EraseLocked(typename std::unordered_map<uint64_t, Entry>::iterator entry)
+        {
+            m_usedBytes -= entry->second.Bytes;
+            m_recentlyUsed.erase(entry->second.RecentlyUsed);
+            m_entries.erase(entry);
+        }
+
+        void EvictLocked()
+        {
+            while (m_usedBytes > m_budgetBytes && !m_recentlyUsed.empty())
+            {
+                EraseLocked(m_entries.find(m_recentlyUsed.back()));
+                ++m_statistics.Evictions;
+            }
+        }
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_idleCondition;
+
+        // Keyed by patch and level, most recently used at the front of the list
+        std::unordered_map<uint64_t, Entry> m_entries;
+        std::list<uint64_t> m_recentlyUsed;
+
+        // Patch version of the newest build queued or running for each level
+        std::unordered_map<uint64_t, uint64_t> m_pending;
+        size_t m_numBuilding = 0;
+
+        size_t m_budgetBytes = 0;
+        size_t m_usedBytes = 0;
+        Statistics m_statistics;
+        ThreadPool* m_pool = nullptr;
+    };
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include "BezierMS.h"
 #include "BezierFileIO.h"
+#include "BezierCulling.h"
 
 #include <cstddef>
 #include <cmath>
@@ -21,6 +22,7 @@ BezierMS::BezierMS(UINT width, UINT height, std::wstring name)
     , m_dsvDescriptorSize(0)
     , m_constantBufferData{}
     , m_cbvDataBegin(nullptr)
+    , m_visiblePatchDataBegin(nullptr)
     , m_frameIndex(0)
     , m_frameCounter(0)
     , m_fenceEvent{}
@@ -214,6 +216,24 @@ void BezierMS::LoadPipeline()
         CD3DX12_RANGE readRange(0, 0);        // We do not intend to read from this resource on the CPU.
         ThrowIfFailed(m_constantBuffer->Map(0, &readRange, reinterpret_cast<void**>(&m_cbvDataBegin)));
     }
+
+    // Create the visible patch list, one slice per frame with room for every patch
+    {
+        const UINT64 visiblePatchBufferSize = sizeof(uint32_t) * m_shape.GetNumPatchs() * FrameCount;
+
+        ThrowIfFailed(m_device->CreateCommittedResource(
+            &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+            D3D12_HEAP_FLAG_NONE,
+            &CD3DX12_RESOURCE_DESC::Buffer(visiblePatchBufferSize),
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&m_visiblePatchBuffer)));
+
+        NAME_D3D12_OBJECT(m_visiblePatchBuffer);
+
+        CD3DX12_RANGE readRange(0, 0);        // We do not intend to read from this resource on the CPU.
+        ThrowIfFailed(m_visiblePatchBuffer->Map(0, &readRange, reinterpret_cast<void**>(&m_visiblePatchDataBegin)));
+    }
 }
 
 // Load the sample assets.
@@ -285,6 +305,7 @@ void BezierMS::LoadGeometry()
     auto& topRightFrontOctant = m_shape.Patches[0];
 
     topRightFrontOctant = BezierFileIO::ReadFromFile<decltype(m_shape)::GetDegree()>(GetAssetFullPath(L"..\\..\\scene\\TopRightFront.bez"));
+    m_shapeBounds.MarkAllDirty();
 
     size_t const vbSizeInBytes = _countof(topRightFrontOctant.ControlPoints) * sizeof(BezierMaths::ControlPoint);
     m_vertices.reserve(topRightFrontOctant.NumControlPoints);
@@ -370,7 +391,13 @@ void BezierMS::OnUpdate()
     XMStoreFloat4x4(&m_constantBufferData.World, XMMatrixTranspose(world));
     XMStoreFloat4x4(&m_constantBufferData.WorldView, XMMatrixTranspose(world * view));
     XMStoreFloat4x4(&m_constantBufferData.WorldViewProj, XMMatrixTranspose(world * view * proj));
-    m_constantBufferData.NumPatches = m_shape.GetNumPatchs();
+
+    // Only patches whose control hull reaches into the frustum are handed to the amplification shader
+    auto const frustum = BezierMaths::Frustum::FromViewProjection(Matrix(world * view * proj));
+    BezierMaths::CullPatches(frustum, m_shapeBounds.GetBounds(m_shape), m_visiblePatches);
+    std::copy(m_visiblePatches.begin(), m_visiblePatches.end(), m_visiblePatchDataBegin + m_shape.GetNumPatchs() * m_frameIndex);
+
+    m_constantBufferData.NumPatches = static_cast<unsigned int>(m_visiblePatches.size());
     m_constantBufferData.NumTesselationRowsPerPatch = tessellationFactor;
     m_constantBufferData.NumTrianglesPerPatch = m_constantBufferData.NumTesselationRowsPerPatch * m_constantBufferData.NumTesselationRowsPerPatch;
 
@@ -448,10 +475,14 @@ void BezierMS::PopulateCommandList()
 
     m_commandList->SetGraphicsRootConstantBufferView(0, m_constantBuffer->GetGPUVirtualAddress() + sizeof(SceneConstantBuffer) * m_frameIndex);
     m_commandList->SetGraphicsRootShaderResourceView(1, m_vertexBuffer->GetGPUVirtualAddress());
+    m_commandList->SetGraphicsRootShaderResourceView(2, m_visiblePatchBuffer->GetGPUVirtualAddress() + sizeof(uint32_t) * m_shape.GetNumPatchs() * m_frameIndex);
 
     // Assert based on max verts our shaders are designed to process
 
-    m_commandList->DispatchMesh(1, 1, 1);
+    if (!m_visiblePatches.empty())
+    {
+        m_commandList->DispatchMesh(1, 1, 1);
+    }
 
     // Indicate that the back buffer will now be used to present.
     m_commandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_renderTargets[m_frameIndex].Get(), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT));
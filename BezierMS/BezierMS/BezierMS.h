@@ -4,6 +4,7 @@
 #include "StepTimer.h"
 #include "SimpleCamera.h"
 #include "BezierMaths.h"
+#include "BezierBounds.h"
 
 #include <vector>
 
@@ -52,12 +53,14 @@ private:
     ComPtr<ID3D12PipelineState> m_pipelineStateWireFrame;
     ComPtr<ID3D12Resource> m_constantBuffer;
     ComPtr<ID3D12Resource> m_vertexBuffer;
+    ComPtr<ID3D12Resource> m_visiblePatchBuffer;
     UINT m_rtvDescriptorSize;
     UINT m_dsvDescriptorSize;
 
     ComPtr<ID3D12GraphicsCommandList6> m_commandList;
     SceneConstantBuffer m_constantBufferData;
     UINT8* m_cbvDataBegin;
+    uint32_t* m_visiblePatchDataBegin;
 
     StepTimer m_timer;
     SimpleCamera m_camera;
@@ -75,6 +78,8 @@ private:
     std::pair<unsigned int, unsigned int> m_tessellationFactors = { 2, 32 };
     float m_adaptiveTessellationRange = 8.f;
     BezierMaths::BezierShape<2, 1> m_shape;
+    BezierMaths::ShapeBoundsCache<2, 1> m_shapeBounds;
+    std::vector<uint32_t> m_visiblePatches;
 
     void LoadPipeline();
     void LoadAssets();
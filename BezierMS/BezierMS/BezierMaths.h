@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <cstdint>
+#include <cstddef>
 #include "SimpleMath.h"
 #include <utility>
 #include <iterator>
@@ -32,6 +33,23 @@ struct Line
 namespace BezierMaths
 {
     using ControlPoint = DirectX::SimpleMath::Vector3;
+
+    // Non-owning view over contiguous elements, stands in for std::span until we move to C++20
+    template<typename T>
+    struct Span
+    {
+        constexpr Span() = default;
+        constexpr Span(T* data, size_t size) : Data(data), Size(size) {}
+
+        constexpr T* begin() const { return Data; }
+        constexpr T* end() const { return Data + Size; }
+        constexpr T& operator[](size_t index) const { return Data[index]; }
+        constexpr bool Empty() const { return Size == 0; }
+
+        T* Data = nullptr;
+        size_t Size = 0;
+    };
+
     constexpr int ceil(float value)
     {
         int intVal = static_cast<int>(value);
@@ -115,9 +133,10 @@ namespace BezierMaths
         BezierTriangle<N> Rotate(DirectX::SimpleMath::Vector3 const& axis, float const angle) const
         {
             BezierTriangle<N> result;
+            auto const rotation = DirectX::SimpleMath::Quaternion::CreateFromAxisAngle(axis, angle);
             for (int i = 0; i < NumControlPoints; ++i)
             {
-                DirectX::SimpleMath::Vector3::Transform(this->ControlPoints[i], DirectX::SimpleMath::Quaternion::CreateFromAxisAngle(axis, angle), result.ControlPoints[i]);
+                DirectX::SimpleMath::Vector3::Transform(this->ControlPoints[i], rotation, result.ControlPoints[i]);
             }
 
             return result;
@@ -140,7 +159,7 @@ namespace BezierMaths
         static_assert(N >= 0, "Degree cannot be negative.");
         static_assert(N >= S, "Degree cannot be smaller than subdivision end degree.");
 
-        static constexpr BezierCurve<S> Curve(BezierCurve<N> curve, float t)
+        static constexpr BezierCurve<S> Curve(BezierCurve<N> const& curve, float t)
         {
             BezierCurve<N - 1u> subCurve;
             for (int i = 0; i < subCurve.NumControlPoints; ++i)
@@ -151,7 +170,7 @@ namespace BezierMaths
             return Decasteljau<N - 1u, S>::Curve(subCurve, t);
         }
 
-        static constexpr BezierTriangle<S> Triangle(BezierTriangle<N> patch, DirectX::SimpleMath::Vector3 const& uvw)
+        static constexpr BezierTriangle<S> Triangle(BezierTriangle<N> const& patch, DirectX::SimpleMath::Vector3 const& uvw)
         {
             BezierTriangle<N - 1u> subpatch;
             auto const& ControlPoints = patch.ControlPoints;
@@ -171,8 +190,8 @@ namespace BezierMaths
     struct Decasteljau<N, N>
     {
         static_assert(N >= 0, "Degree cannot be negative.");
-        static constexpr BezierCurve<N> Curve(BezierCurve<N> curve, float t) { return curve; }
-        static constexpr BezierTriangle<N> Triangle(BezierTriangle<N> patch, DirectX::SimpleMath::Vector3 const& uvw) { return patch; }
+        static constexpr BezierCurve<N> Curve(BezierCurve<N> const& curve, float t) { return curve; }
+        static constexpr BezierTriangle<N> Triangle(BezierTriangle<N> const& patch, DirectX::SimpleMath::Vector3 const& uvw) { return patch; }
     };
 
     template<unsigned N>
@@ -204,9 +223,10 @@ namespace BezierMaths
         auto const& triangle = Decasteljau<N, 1>::Triangle(patch, uvw);
         auto const& vertices = triangle.ControlPoints;
 
-        ControlPoint const& p010 = vertices[TriangularIndex<N>::To1D(1, 0)];
-        ControlPoint const& p100 = vertices[TriangularIndex<N>::To1D(0, 0)];
-        ControlPoint const& p001 = vertices[TriangularIndex<N>::To1D(0, 1)];
+        // The last level is a linear patch so index it as one
+        ControlPoint const& p010 = vertices[TriangularIndex<1>::To1D(1, 0)];
+        ControlPoint const& p100 = vertices[TriangularIndex<1>::To1D(0, 0)];
+        ControlPoint const& p001 = vertices[TriangularIndex<1>::To1D(0, 1)];
 
         auto tangent = p100 - p010;
         auto biTangent = p001 - p010;
@@ -252,81 +272,6 @@ namespace BezierMaths
         return result;
     }
 
-    template<unsigned N>
-    std::vector<Triangle> TessellatePatch(BezierTriangle<N> const& patch)
-    {
-        using Vector3 = DirectX::SimpleMath::Vector3;
-
-        static constexpr int numRows = 16;
-        static constexpr int numTotalTris = numRows * numRows;
-        static constexpr float step = 1.f / numRows;
-
-        std::vector<Triangle> result;
-
-        // Reserve space for all triangles
-        // Use sum of arithemetic series to detrmine the total size
-        // Turns out the sum of series = n*n
-        result.reserve(numTotalTris);
-
-        // Add a minor tolerance to account for FP inaccuracies
-        float end = 0.f + step - 0.0001f;
-        for (int row = 0; row < numRows; ++row)
-        {
-            float topV, botV;
-            topV = 1.f - row * step;
-            botV = 1.f - ((row + 1) * step);
-            Vector3 topLeft = { 1.f - topV, topV, 0.f };
-            Vector3 topRight = { 0.f, topV, 1.f - topV };
-
-            Vector3 botLeft = { 1.f - botV, botV, 0.f };
-            Vector3 botRight = { 0.f, botV, 1.f - botV };
-
-            // Compute the first edge
-            Vector3 topVert = lerp(topLeft, topRight, 0.f);
-            Vector3 botLeftVert = lerp(botLeft, botRight, 0.f);
-
-            auto lastEdge = std::make_pair<Vertex>(Evaluate(patch, botLeftVert), Evaluate(patch, topVert));
-            int const numRowTris = (2 * row + 1);
-
-            // Compute the triangle strip for each layer
-            for (int triIdx = 0; triIdx < numRowTris; ++triIdx)
-            {
-                static const auto norm = Vector3{ 0.f, 0.f, 1.f };
-                if (triIdx % 2 == 0)
-                {
-                    // Skip intermediate triangles when calculating interpolation t which do not contribute in change of horizontal(uw) parameter span
-                    // In total there will be floor(nTris / 2) such triangles
-                    Vector3 botRightVert = lerp(botLeft, botRight, (float(triIdx - (triIdx / 2)) + 1.f) / (float(row) + 1.f));
-                    result.push_back({ lastEdge.first, lastEdge.second, Evaluate(patch, botRightVert) });
-                    lastEdge = { lastEdge.second, result.back().vertices[2] };
-                }
-                else
-                {
-                    // Skip intermediate triangles when calculating interpolation t which do not contribute in change of horizontal(uw) parameter span
-                    // In total there will be floor(nTris / 2) such triangles
-                    Vector3 topRightVert = lerp(topLeft, topRight, (float(triIdx - (triIdx / 2))) / float(row));
-                    result.push_back({ lastEdge.first, Evaluate(patch, topRightVert), lastEdge.second });
-                    lastEdge = { lastEdge.second, result.back().vertices[1] };
-                }
-            }
-        }
-
-        return result;
-    }
-
-    template<unsigned N, unsigned M>
-    std::vector<Triangle> TessellateShape(BezierShape<N, M> const& shape)
-    {
-        std::vector<Triangle> result;
-        for (int i = 0; i < M; ++i)
-        {
-            auto tesselatedPatch = TessellatePatch(shape.Patches[i]);
-            std::move(tesselatedPatch.begin(), tesselatedPatch.end(), back_inserter(result));
-        }
-
-        return result;
-    }
-
     template<unsigned N>
     constexpr BezierTriangle<N + 1> Elevate(BezierTriangle<N> const& patch)
     {
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <algorithm>
+
+#include "BezierMaths.h"
+#include "BezierSimd.h"
+#include "BezierBatch.h"
+
+namespace BezierMaths
+{
+    // Structure of arrays store for patches of one degree
+    // Every control point slot has its own x, y and z arrays with one float per patch, so a register load picks up the same slot of
+    // FloatLanes::Width neighbouring patches. Arrays start on a cache line and the patch capacity is kept a multiple of a cache line
+    //
+    // The mesh shader reads Patches as float3s one patch after another, which can't alias this layout
+    // GetPackedControlPoints keeps that layout as a mirror that is rebuilt only after an edit, so an upload stays a single memcpy
+    template<unsigned N>
+    class BezierPatchStore
+    {
+    public:
+        static constexpr unsigned NumControlPoints = BezierTriangle<N>::NumControlPoints;
+
+        // Patches per cache line, capacity is always a multiple of it
+        static constexpr size_t PatchGranularity = Simd::CacheLineAlignment / sizeof(float);
+
+        BezierPatchStore() = default;
+
+        explicit BezierPatchStore(size_t capacity)
+        {
+            Reserve(capacity);
+        }
+
+        template<unsigned M>
+        explicit BezierPatchStore(BezierShape<N, M> const& shape)
+        {
+            Reserve(M);
+            for (auto const& patch : shape.Patches)
+            {
+                Add(patch);
+            }
+        }
+
+        size_t GetNumPatches() const { return m_numPatches; }
+
+        // Length of every component array, the lanes past GetNumPatches are zero
+        size_t GetCapacity() const { return m_capacity; }
+
+        // Bumped on every edit, caches derived from the store compare it against the value they were built from
+        uint64_t GetVersion() const { return m_version; }
+
+        // Version of the last edit that touched index, writes through X, Y or Z count against every patch
+        uint64_t GetPatchVersion(size_t index) const
+        {
+            assert(index < m_numPatches);
+            return (std::max)(m_patchVersions[index], m_bulkVersion);
+        }
+
+        void Reserve(size_t capacity)
+        {
+            capacity = (capacity + PatchGranularity - 1) / PatchGranularity * PatchGranularity;
+            if (capacity <= m_capacity)
+            {
+                return;
+            }
+
+            std::vector<float, Simd::AlignedAllocator<float>> data(capacity * NumControlPoints * 3, 0.f);
+            for (unsigned component = 0; m_numPatches > 0 && component < NumControlPoints * 3; ++component)
+            {
+                std::copy_n(m_data.data() + component * m_capacity, m_numPatches, data.data() + component * capacity);
+            }
+
+            m_data = std::move(data);
+            m_patchVersions.resize(capacity, 0);
+            m_capacity = capacity;
+        }
+
+        size_t Add(BezierTriangle<N> const& patch)
+        {
+            if (m_numPatches == m_capacity)
+            {
+                Reserve((std::max)(m_capacity * 2, PatchGranularity));
+            }
+
+            size_t const index = m_numPatches++;
+            Set(index, patch);
+            return index;
+        }
+
+        void Set(size_t index, BezierTriangle<N> const& patch)
+        {
+            assert(index < m_numPatches);
+            for (unsigned slot = 0; slot < NumControlPoints; ++slot)
+            {
+                m_data[(slot * 3 + 0) * m_capacity + index] = patch.ControlPoints[slot].x;
+                m_data[(slot * 3 + 1) * m_capacity + index] = patch.ControlPoints[slot].y;
+                m_data[(slot * 3 + 2) * m_capacity + index] = patch.ControlPoints[slot].z;
+            }
+
+            m_patchVersions[index] = ++m_version;
+        }
+
+        BezierTriangle<N> Get(size_t index) const
+        {
+            assert(index < m_numPatches);
+
+            BezierTriangle<N> result;
+            for (unsigned slot = 0; slot < NumControlPoints; ++slot)
+            {
+                result.ControlPoints[slot] = { X(slot)[index], Y(slot)[index], Z(slot)[index] };
+            }
+
+            return result;
+        }
+
+        // Grows with zeroed patches or drops the patches past numPatches, then counts as an edit of every patch
+        // Lets bulk writers fill the component arrays through X, Y and Z without going patch by patch through Add
+        void Resize(size_t numPatches)
+        {
+            Reserve(numPatches);
+            for (unsigned component = 0; numPatches < m_numPatches && component < NumControlPoints * 3; ++component)
+            {
+                std::fill(m_data.data() + component * m_capacity + numPatches, m_data.data() + component * m_capacity + m_numPatches, 0.f);
+            }
+
+            m_numPatches = numPatches;
+            MarkAllEdited();
+        }
+
+        void Clear()
+        {
+            std::fill(m_data.begin(), m_data.end(), 0.f);
+            m_numPatches = 0;
+            MarkAllEdited();
+        }
+
+        // Component arrays of one control point slot, GetCapacity floats each, null while the store has no capacity
+        float const* X(unsigned slot) const { return m_data.data() + (slot * 3 + 0) * m_capacity; }
+        float const* Y(unsigned slot) const { return m_data.data() + (slot * 3 + 1) * m_capacity; }
+        float const* Z(unsigned slot) const { return m_data.data() + (slot * 3 + 2) * m_capacity; }
+
+        // Writable access counts as an edit of every patch
+        float* X(unsigned slot) { MarkAllEdited(); return m_data.data() + (slot * 3 + 0) * m_capacity; }
+        float* Y(unsigned slot) { MarkAllEdited(); return m_data.data() + (slot * 3 + 1) * m_capacity; }
+        float* Z(unsigned slot) { MarkAllEdited(); return m_data.data() + (slot * 3 + 2) * m_capacity; }
+
+        // Control points patch after patch in the layout the mesh shader's Patches buffer expects
+        Span<ControlPoint const> GetPackedControlPoints() const
+        {
+            if (m_packedVersion != m_version || m_packed.size() != m_numPatches * NumControlPoints)
+            {
+                m_packed.resize(m_numPatches * NumControlPoints);
+                for (size_t patch = 0; patch < m_numPatches; ++patch)
+                {
+                    for (unsigned slot = 0; slot < NumControlPoints; ++slot)
+                    {
+                        m_packed[patch * NumControlPoints + slot] = { X(slot)[patch], Y(slot)[patch], Z(slot)[patch] };
+                    }
+                }
+
+                m_packedVersion = m_version;
+            }
+
+            return { m_packed.data(), m_packed.size() };
+        }
+
+        // Loads slot of FloatLanes::Width patches starting at first, first must be a multiple of the width
+        Simd::Vector3Lanes LoadControlPoint(unsigned slot, size_t first) const
+        {
+            return { Simd::Load(X(slot) + first), Simd::Load(Y(slot) + first), Simd::Load(Z(slot) + first) };
+        }
+
+    private:
+        void MarkAllEdited()
+        {
+            m_bulkVersion = ++m_version;
+        }
+
+        std::vector<float, Simd::AlignedAllocator<float>> m_data;
+        size_t m_numPatches = 0;
+        size_t m_capacity = 0;
+        uint64_t m_version = 0;
+
+        // Per patch edit versions and the version of the last edit that could have touched any patch
+        std::vector<uint64_t> m_patchVersions;
+        uint64_t m_bulkVersion = 0;
+
+        mutable std::vector<ControlPoint> m_packed;
+        mutable uint64_t m_packedVersion = ~uint64_t(0);
+    };
+
+    // Evaluates every patch of the store at the same barycentric coordinate, one register of patches at a time
+    // out receives GetNumPatches positions and normals, the same values Evaluate gives patch by patch to float rounding
+    template<unsigned N>
+    void EvaluatePatches(BezierPatchStore<N> const& store, DirectX::SimpleMath::Vector3 const& uvw, VertexStreams const& out)
+    {
+        using namespace Simd;
+        constexpr unsigned Width = FloatLanes::Width;
+
+        size_t const numPatches = store.GetNumPatches();
+        FloatLanes const u = Set1(uvw.x), v = Set1(uvw.y), w = Set1(uvw.z);
+
+        Vector3Lanes points[BezierTriangle<N>::NumControlPoints];
+        Vector3Lanes position, normal;
+
+        // Capacity is a multiple of the register width so the last register never reads past the arrays
+        for (size_t first = 0; first < numPatches; first += Width)
+        {
+            for (unsigned slot = 0; slot < BezierTriangle<N>::NumControlPoints; ++slot)
+            {
+                points[slot] = store.LoadControlPoint(slot, first);
+            }
+
+            EvaluateLanes<N>(points, u, v, w, position, normal);
+
+            alignas(CacheLineAlignment) float lanes[6][Width];
+            Store(lanes[0], position.x);
+            Store(lanes[1], position.y);
+            Store(lanes[2], position.z);
+            Store(lanes[3], normal.x);
+            Store(lanes[4], normal.y);
+            Store(lanes[5], normal.z);
+
+            size_t const count = (std::min)(size_t(Width), numPatches - first);
+            std::copy_n(lanes[0], count, &out.PositionX[first]);
+            std::copy_n(lanes[1], count, &out.PositionY[first]);
+            std::copy_n(lanes[2], count, &out.PositionZ[first]);
+            std::copy_n(lanes[3], count, &out.NormalX[first]);
+            std::copy_n(lanes[4], count, &out.NormalY[first]);
+            std::copy_n(lanes[5], count, &out.NormalZ[first]);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <algorithm>
+
+#include "BezierMaths.h"
+#include "BezierSimd.h"
+#include "BezierPatchStore.h"
+
+namespace BezierMaths
+{
+    enum class QuantisationBounds
+    {
+        // One box around every control point of the store, smallest encoding
+        PerShape,
+
+        // One box per patch, more accurate when patches are small next to the whole shape
+        PerPatch,
+    };
+
+    // Control points of a store as 16 bit fixed point against a bounding box, 6 bytes a point instead of 12
+    //
+    // Each axis of the box is cut into 65535 equal steps of size extent / 65535 and a coordinate is stored as the nearest step.
+    // Decoding gives min + q * step in float, so every coordinate comes back within half a step of the original plus
+    // float rounding of the result, GetErrorBound gives that bound for the whole store
+    //
+    // Steps are laid out like the store, one array per slot and axis with one entry per patch, so every slot decodes on its own
+    template<unsigned N>
+    class QuantisedPatches
+    {
+    public:
+        static constexpr unsigned NumControlPoints = BezierTriangle<N>::NumControlPoints;
+        static constexpr uint32_t NumSteps = 65535;
+
+        QuantisedPatches() = default;
+
+        static QuantisedPatches Encode(BezierPatchStore<N> const& store, QuantisationBounds bounds = QuantisationBounds::PerShape)
+        {
+            QuantisedPatches result;
+            result.m_bounds = bounds;
+            result.m_numPatches = store.GetNumPatches();
+
+            // Padded to the store's granularity so a register load of steps never runs past the arrays
+            size_t const granularity = BezierPatchStore<N>::PatchGranularity;
+            result.m_stride = (result.m_numPatches + granularity - 1) / granularity * granularity;
+            result.m_quantised.assign(result.m_stride * NumControlPoints * 3, 0);
+
+            size_t const numBoxes = bounds == QuantisationBounds::PerShape ? 1 : result.m_stride;
+            for (unsigned axis = 0; axis < 3; ++axis)
+            {
+                result.m_min[axis].assign(numBoxes, 0.f);
+                result.m_step[axis].assign(numBoxes, 0.f);
+            }
+
+            size_t const numUsedBoxes = bounds == QuantisationBounds::PerShape ? 1 : result.m_numPatches;
+            for (unsigned axis = 0; axis < 3; ++axis)
+            {
+                for (size_t box = 0; box < numUsedBoxes; ++box)
+                {
+                    size_t const begin = bounds == QuantisationBounds::PerShape ? 0 : box;
+                    size_t const end = bounds == QuantisationBounds::PerShape ? result.m_numPatches : box + 1;
+
+                    float low = (std::numeric_limits<float>::max)();
+                    float high = std::numeric_limits<float>::lowest();
+                    for (unsigned slot = 0; slot < NumControlPoints; ++slot)
+                    {
+                        float const* const values = GetComponent(store, slot, axis);
+                        for (size_t patch = begin; patch < end; ++patch)
+                        {
+                            low = (std::min)(low, values[patch]);
+                            high = (std::max)(high, values[patch]);
+                        }
+                    }
+
+                    if (begin == end)
+                    {
+                        continue;
+                    }
+
+                    // Round the step up so min + NumSteps * step still reaches the top of the box
+                    double const extent = double(high) - double(low);
+                    float step = static_cast<float>(extent / NumSteps);
+                    if (double(step) * NumSteps < extent)
+                    {
+                        step = std::nextafter(step, (std::numeric_limits<float>::max)());
+                    }
+
+                    result.m_min[axis][box] = low;
+                    result.m_step[axis][box] = step;
+                }
+            }
+
+            for (unsigned axis = 0; axis < 3; ++axis)
+            {
+                for (size_t patch = 0; patch < result.m_numPatches; ++patch)
+                {
+                    size_t const box = bounds == QuantisationBounds::PerShape ? 0 : patch;
+                    double const low = result.m_min[axis][box];
+                    double const step = result.m_step[axis][box];
+
+                    for (unsigned slot = 0; slot < NumControlPoints; ++slot)
+                    {
+                        double const scaled = step > 0. ? std::round((GetComponent(store, slot, axis)[patch] - low) / step) : 0.;
+                        result.m_quantised[result.GetOffset(slot, axis) + patch] = static_cast<uint16_t>((std::min)((std::max)(scaled, 0.), double(NumSteps)));
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        // Replaces the contents of store with the decoded patches
+        // Whole registers of patches are decoded with SIMD, the last partial one goes through the scalar path so the padding lanes stay zero
+        void Decode(BezierPatchStore<N>& store) const
+        {
+            using namespace Simd;
+            constexpr unsigned Width = FloatLanes::Width;
+
+            store.Resize(m_numPatches);
+
+            float* outputs[NumControlPoints][3];
+            for (unsigned slot = 0; slot < NumControlPoints; ++slot)
+            {
+                outputs[slot][0] = store.X(slot);
+                outputs[slot][1] = store.Y(slot);
+                outputs[slot][2] = store.Z(slot);
+            }
+
+            bool const perPatch = m_bounds == QuantisationBounds::PerPatch;
+            size_t const numFull = m_numPatches / Width * Width;
+            for (size_t first = 0; first < numFull; first += Width)
+            {
+                for (unsigned axis = 0; axis < 3; ++axis)
+                {
+                    FloatLanes const low = perPatch ? LoadUnaligned(&m_min[axis][first]) : Set1(m_min[axis][0]);
+                    FloatLanes const step = perPatch ? LoadUnaligned(&m_step[axis][first]) : Set1(m_step[axis][0]);
+
+                    for (unsigned slot = 0; slot < NumControlPoints; ++slot)
+                    {
+                        Store(outputs[slot][axis] + first, MulAdd(LoadUInt16(&m_quantised[GetOffset(slot, axis) + first]), step, low));
+                    }
+                }
+            }
+
+            for (size_t patch = numFull; patch < m_numPatches; ++patch)
+            {
+                for (unsigned axis = 0; axis < 3; ++axis)
+                {
+                    size_t const box = perPatch ? patch : 0;
+                    for (unsigned slot = 0; slot < NumControlPoints; ++slot)
+                    {
+                        outputs[slot][axis][patch] = float(m_quantised[GetOffset(slot, axis) + patch]) * m_step[axis][box] + m_min[axis][box];
+                    }
+                }
+            }
+        }
+
+        // Single patch without decoding the rest, matches Decode to float rounding
+        BezierTriangle<N> DecodePatch(size_t index) const
+        {
+            assert(index < m_numPatches);
+
+            BezierTriangle<N> result;
+            size_t const box = m_bounds == QuantisationBounds::PerPatch ? index : 0;
+            for (unsigned axis = 0; axis < 3; ++axis)
+            {
+                for (unsigned slot = 0; slot < NumControlPoints; ++slot)
+                {
+                    (&result.ControlPoints[slot].x)[axis] = float(m_quantised[GetOffset(slot, axis) + index]) * m_step[axis][box] + m_min[axis][box];
+                }
+            }
+
+            return result;
+        }
+
+        size_t GetNumPatches() const { return m_numPatches; }
+        QuantisationBounds GetBounds() const { return m_bounds; }
+
+        // Bytes of steps and bounds held
+        size_t GetSizeBytes() const
+        {
+            size_t size = m_quantised.size() * sizeof(uint16_t);
+            for (unsigned axis = 0; axis < 3; ++axis)
+            {
+                size += (m_min[axis].size() + m_step[axis].size()) * sizeof(float);
+            }
+
+            return size;
+        }
+
+        // Largest difference between an original and a decoded coordinate on any axis of any patch
+        // Half a step for the quantisation, plus a rounding of the product and the sum for the float decode
+        float GetErrorBound() const
+        {
+            double bound = 0.;
+            for (unsigned axis = 0; axis < 3; ++axis)
+            {
+                size_t const numBoxes = m_bounds == QuantisationBounds::PerShape ? 1 : m_numPatches;
+                for (size_t box = 0; box < (std::min)(numBoxes, m_min[axis].size()); ++box)
+                {
+                    double const step = m_step[axis][box];
+                    double const extent = step * NumSteps;
+                    double const magnitude = (std::max)(std::abs(double(m_min[axis][box])), std::abs(m_min[axis][box] + extent));
+                    bound = (std::max)(bound, step / 2. + (extent + magnitude) * std::numeric_limits<float>::epsilon());
+                }
+            }
+
+            return static_cast<float>(bound);
+        }
+
+    private:
+        static float const* GetComponent(BezierPatchStore<N> const& store, unsigned slot, unsigned axis)
+        {
+            return axis == 0 ? store.X(slot) : axis == 1 ? store.Y(slot) : store.Z(slot);
+        }
+
+        size_t GetOffset(unsigned slot, unsigned axis) const
+        {
+            return (size_t(slot) * 3 + axis) * m_stride;
+        }
+
+        QuantisationBounds m_bounds = QuantisationBounds::PerShape;
+        size_t m_numPatches = 0;
+        size_t m_stride = 0;
+
+        // Slot major like the store, m_quantised[GetOffset(slot, axis) + patch]
+        std::vector<uint16_t> m_quantised;
+
+        // Box of each axis, one entry for PerShape or one per patch for PerPatch
+        std::vector<float> m_min[3];
+        std::vector<float> m_step[3];
+    };
+}
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "stdafx.h"
+#include "BezierSceneIO.h"
+#include "BezierFileIO.h"
+
+#include <filesystem>
+
+using namespace BezierMaths;
+
+namespace BezierFileIO
+{
+    ScenePatchReader::ScenePatchReader(std::wstring const& filePath, SceneReadOptions const& options)
+        : m_file(std::filesystem::path(filePath), std::ios::binary), m_options(options)
+    {
+        if (!m_file)
+        {
+            throw std::runtime_error("Couldn't open " + std::filesystem::path(filePath).string() + ".");
+        }
+    }
+
+    Span<BezierTriangleView const> ScenePatchReader::ReadChunk()
+    {
+        m_controlPoints.clear();
+        m_patches.clear();
+
+        while (m_patches.size() < m_options.PatchesPerChunk)
+        {
+            size_t const end = FindPatchEnd();
+            if (end > 0)
+            {
+                ParsePatch(end);
+                continue;
+            }
+
+            if (!ReadBlock())
+            {
+                // Anything but whitespace left over is a patch cut short, parsing it reports where
+                TextParser parser(std::string_view(m_text).substr(m_start), m_line, m_column);
+                if (!parser.AtEnd())
+                {
+                    parser.ParsePatch([](ControlPoint const&) {});
+                    parser.Fail("unexpected end of file");
+                }
+
+                break;
+            }
+        }
+
+        // Control points are only final once the chunk is complete
+        ControlPoint const* controlPoints = m_controlPoints.data();
+        for (auto& patch : m_patches)
+        {
+            patch.ControlPoints.Data = controlPoints;
+            controlPoints += patch.ControlPoints.Size;
+        }
+
+        return { m_patches.data(), m_patches.size() };
+    }
+
+    size_t ScenePatchReader::FindPatchEnd()
+    {
+        for (; m_scanned < m_text.size(); ++m_scanned)
+        {
+            char const c = m_text[m_scanned];
+            if (c == '{')
+            {
+                ++m_depth;
+            }
+            else if (c == '}')
+            {
+                --m_depth;
+            }
+            else if (m_depth > 0 || c == ' ' || c == '\n' || c == '\r' || c == '\t')
+            {
+                continue;
+            }
+
+            // A patch closed, or something outside of one that the parser will complain about
+            if (m_depth <= 0)
+            {
+                m_depth = 0;
+                return ++m_scanned;
+            }
+        }
+
+        return 0;
+    }
+
+    bool ScenePatchReader::ReadBlock()
+    {
+        m_text.erase(0, m_start);
+        m_scanned -= m_start;
+        m_start = 0;
+
+        size_t const size = m_text.size();
+        m_text.resize(size + m_options.BlockSize);
+        m_file.read(&m_text[size], static_cast<std::streamsize>(m_options.BlockSize));
+        m_text.resize(size + static_cast<size_t>(m_file.gcount()));
+
+        return m_text.size() > size;
+    }
+
+    void ScenePatchReader::ParsePatch(size_t end)
+    {
+        std::string_view const text(m_text.data() + m_start, end - m_start);
+        TextParser parser(text, m_line, m_column);
+
+        size_t const first = m_controlPoints.size();
+        parser.ParsePatch([this](ControlPoint const& point) { m_controlPoints.push_back(point); });
+
+        size_t const count = m_controlPoints.size() - first;
+        unsigned const degree = DegreeFromNumControlPoints(count);
+        if (degree == 0)
+        {
+            parser.Fail(std::to_string(count) + " control points don't form a Bezier triangle");
+        }
+
+        // Pointers are filled in by ReadChunk, m_controlPoints may still move
+        m_patches.push_back({ degree, { nullptr, count } });
+        ++m_numPatchesRead;
+
+        for (char const c : text)
+        {
+            m_column = c == '\n' ? 1 : m_column + 1;
+            m_line += c == '\n' ? 1 : 0;
+        }
+
+        m_start = end;
+    }
+}
\ No newline at end of file
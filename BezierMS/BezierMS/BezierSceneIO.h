@@ -0,0 +1,260 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <stdexcept>
+#include <exception>
+#include <algorithm>
+#include <filesystem>
+
+#include "BezierMaths.h"
+#include "BezierFileIO.h"
+#include "BezierBinaryIO.h"
+#include "BezierPatchStore.h"
+#include "BezierTriangleView.h"
+#include "ThreadPool.h"
+
+namespace BezierFileIO
+{
+    struct SceneReadOptions
+    {
+        // Patches handed out per chunk
+        size_t PatchesPerChunk = 4096;
+
+        // Bytes read from the file at a time, a patch that doesn't fit grows the buffer until it does
+        size_t BlockSize = size_t(1) << 20;
+    };
+
+    // Streaming reader for scene files, which are .bez patches one after another, each with its own degree
+    // A single patch .bez file is a scene of one patch. Memory stays at about one block of text plus one chunk of patches for any file size
+    // Errors throw ParseError with the line and column in the whole file
+    class ScenePatchReader
+    {
+    public:
+        explicit ScenePatchReader(std::wstring const& filePath, SceneReadOptions const& options = {});
+
+        // Next chunk of up to PatchesPerChunk patches in file order, empty once the file is done
+        // The views stay valid until the next call
+        BezierMaths::Span<BezierMaths::BezierTriangleView const> ReadChunk();
+
+        // Patches read so far
+        size_t GetNumPatchesRead() const { return m_numPatchesRead; }
+
+    private:
+        // Offset one past the end of the next whole patch in m_text, or 0 if the text doesn't hold one yet
+        size_t FindPatchEnd();
+        bool ReadBlock();
+        void ParsePatch(size_t end);
+
+        std::ifstream m_file;
+        SceneReadOptions m_options;
+
+        // Text from the file, parsed up to m_start and brace counted up to m_scanned
+        std::string m_text;
+        size_t m_start = 0;
+        size_t m_scanned = 0;
+        int m_depth = 0;
+
+        // Where m_start is in the file
+        size_t m_line = 1;
+        size_t m_column = 1;
+
+        std::vector<BezierMaths::ControlPoint> m_controlPoints;
+        std::vector<BezierMaths::BezierTriangleView> m_patches;
+        size_t m_numPatchesRead = 0;
+    };
+
+    // Calls visit(Span<BezierTriangleView const>) for each chunk of the scene, returns the number of patches
+    template<typename Visitor>
+    size_t ReadScene(std::wstring const& filePath, Visitor&& visit, SceneReadOptions const& options = {})
+    {
+        ScenePatchReader reader(filePath, options);
+        for (auto chunk = reader.ReadChunk(); !chunk.Empty(); chunk = reader.ReadChunk())
+        {
+            visit(chunk);
+        }
+
+        return reader.GetNumPatchesRead();
+    }
+
+    // Appends every patch of the scene to store, every patch has to be of degree N
+    template<unsigned N>
+    size_t ReadScene(std::wstring const& filePath, BezierMaths::BezierPatchStore<N>& store, SceneReadOptions const& options = {})
+    {
+        size_t index = 0;
+        return ReadScene(filePath, [&](BezierMaths::Span<BezierMaths::BezierTriangleView const> patches)
+        {
+            for (auto const& patch : patches)
+            {
+                if (patch.Degree != N)
+                {
+                    throw std::runtime_error("Patch " + std::to_string(index) + " has degree " + std::to_string(patch.Degree) + ", the store holds degree " + std::to_string(N) + ".");
+                }
+
+                store.Add(patch.ToFixed<N>());
+                ++index;
+            }
+        }, options);
+    }
+
+    // Appends every patch of the scene to patches, any mix of degrees
+    inline size_t ReadScene(std::wstring const& filePath, std::vector<BezierMaths::DynamicBezierTriangle>& patches, SceneReadOptions const& options = {})
+    {
+        return ReadScene(filePath, [&](BezierMaths::Span<BezierMaths::BezierTriangleView const> chunk)
+        {
+            for (auto const& patch : chunk)
+            {
+                patches.push_back({ patch.Degree, { patch.ControlPoints.begin(), patch.ControlPoints.end() } });
+            }
+        }, options);
+    }
+
+    struct FileLoadError
+    {
+        std::filesystem::path Path;
+        std::string Message;
+    };
+
+    struct DirectoryLoadReport
+    {
+        size_t NumFiles = 0;
+        size_t NumPatches = 0;
+
+        // One entry per file that couldn't be loaded, in path order
+        std::vector<FileLoadError> Errors;
+    };
+
+    // Appends the patches of every .bez file in directory to store
+    // Files are read and parsed as pool tasks and merged in sorted path order, so the store comes out the same on any number of threads
+    // A file that can't be read or parsed, or holds a patch of another degree, adds nothing and is reported in Errors, the rest still load
+    // Throws only if the directory itself can't be listed
+    template<unsigned N>
+    DirectoryLoadReport LoadDirectory(std::filesystem::path const& directory, BezierMaths::BezierPatchStore<N>& store, ThreadPool& pool = ThreadPool::GetDefault())
+    {
+        std::vector<std::filesystem::path> paths;
+        for (auto const& entry : std::filesystem::directory_iterator(directory))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == ".bez")
+            {
+                paths.push_back(entry.path());
+            }
+        }
+
+        std::sort(paths.begin(), paths.end());
+
+        struct FileResult
+        {
+            std::vector<BezierMaths::BezierTriangle<N>> Patches;
+            std::string Error;
+        };
+
+        std::vector<FileResult> results(paths.size());
+
+        // Files are small and uneven, one per task lets idle workers steal the slow ones
+        pool.ParallelFor(paths.size(), 1, [&](size_t begin, size_t end)
+        {
+            for (size_t file = begin; file < end; ++file)
+            {
+                try
+                {
+                    std::string const text = ReadTextFile(paths[file].wstring());
+                    TextParser parser(text);
+                    while (!parser.AtEnd())
+                    {
+                        results[file].Patches.push_back(ParsePatch<N>(parser));
+                    }
+                }
+                catch (std::exception const& error)
+                {
+                    results[file].Patches.clear();
+                    results[file].Error = error.what();
+                }
+            }
+        });
+
+        DirectoryLoadReport report;
+        report.NumFiles = paths.size();
+
+        size_t numPatches = 0;
+        for (auto const& result : results)
+        {
+            numPatches += result.Patches.size();
+        }
+
+        store.Reserve(store.GetNumPatches() + numPatches);
+        for (size_t file = 0; file < paths.size(); ++file)
+        {
+            if (!results[file].Error.empty())
+            {
+                report.Errors.push_back({ paths[file], std::move(results[file].Error) });
+                continue;
+            }
+
+            for (auto const& patch : results[file].Patches)
+            {
+                store.Add(patch);
+            }
+
+            report.NumPatches += results[file].Patches.size();
+        }
+
+        return report;
+    }
+
+    enum class SceneFormat
+    {
+        // .bez patches one after another, any mix of degrees
+        Text,
+
+        // BinaryPatchHeader and packed control points, one degree per file
+        Binary,
+    };
+
+    // Any number of patches of any degrees as a text scene, throws if the file already exists
+    inline void WriteScene(std::wstring const& filePath, BezierMaths::Span<BezierMaths::BezierTriangleView const> patches, int precision = -1)
+    {
+        PatchTextWriter writer(filePath, precision);
+        for (auto const& patch : patches)
+        {
+            writer.Write(patch);
+        }
+
+        writer.Close();
+    }
+
+    template<unsigned N, unsigned M>
+    void WriteScene(std::wstring const& filePath, BezierMaths::BezierShape<N, M> const& shape, SceneFormat format = SceneFormat::Text)
+    {
+        if (format == SceneFormat::Binary)
+        {
+            WriteBinaryFile(filePath, shape);
+            return;
+        }
+
+        PatchTextWriter writer(filePath);
+        writer.Write(shape);
+        writer.Close();
+    }
+
+    template<unsigned N>
+    void WriteScene(std::wstring const& filePath, BezierMaths::BezierPatchStore<N> const& store, SceneFormat format = SceneFormat::Text)
+    {
+        if (format == SceneFormat::Binary)
+        {
+            WriteBinaryFile(filePath, store);
+            return;
+        }
+
+        // The packed mirror already holds every patch as a run of control points, the views point straight into it
+        auto const controlPoints = store.GetPackedControlPoints();
+
+        PatchTextWriter writer(filePath);
+        for (size_t patch = 0; patch < store.GetNumPatches(); ++patch)
+        {
+            writer.Write(BezierMaths::BezierTriangleView(N, { controlPoints.Data + patch * BezierMaths::BezierTriangle<N>::NumControlPoints, BezierMaths::BezierTriangle<N>::NumControlPoints }));
+        }
+
+        writer.Close();
+    }
+}
\ No newline at end of file
@@ -5,7 +5,8 @@
 #define MAX_TRIANGLES_PER_GROUP 85
 
 #define ROOT_SIG "CBV(b0), \
-                  SRV(t0)"
+                  SRV(t0), \
+                  SRV(t1)"
 
 struct Constants
 {
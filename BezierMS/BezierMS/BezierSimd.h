@@ -0,0 +1,198 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+
+// Pick the widest float register the build targets
+// MSVC only defines __AVX2__ under /arch:AVX2, x64 always has SSE2
+// Define BEZIER_SIMD_SCALAR (or _XM_NO_INTRINSICS_) to force the scalar fallback
+#if !defined(BEZIER_SIMD_SCALAR) && !defined(_XM_NO_INTRINSICS_)
+#if defined(__AVX2__)
+#define BEZIER_SIMD_AVX2
+#include <immintrin.h>
+#elif defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__)
+#define BEZIER_SIMD_SSE
+#include <emmintrin.h>
+#endif
+#endif
+
+namespace BezierMaths::Simd
+{
+    // A register of float lanes, operations on it are applied per lane
+    struct FloatLanes
+    {
+#if defined(BEZIER_SIMD_AVX2)
+        static constexpr unsigned Width = 8;
+        __m256 v;
+#elif defined(BEZIER_SIMD_SSE)
+        static constexpr unsigned Width = 4;
+        __m128 v;
+#else
+        static constexpr unsigned Width = 1;
+        float v;
+#endif
+    };
+
+    // Alignment required by Load and Store
+    static constexpr unsigned LaneAlignment = FloatLanes::Width * sizeof(float);
+
+#if defined(BEZIER_SIMD_AVX2)
+    inline FloatLanes Set1(float value) { return { _mm256_set1_ps(value) }; }
+    inline FloatLanes Load(float const* src) { return { _mm256_load_ps(src) }; }
+    inline FloatLanes LoadUnaligned(float const* src) { return { _mm256_loadu_ps(src) }; }
+    inline void Store(float* dst, FloatLanes a) { _mm256_store_ps(dst, a.v); }
+    inline void StoreUnaligned(float* dst, FloatLanes a) { _mm256_storeu_ps(dst, a.v); }
+
+    // Width unsigned 16 bit integers as floats, src needn't be aligned
+    inline FloatLanes LoadUInt16(uint16_t const* src) { return { _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(src)))) }; }
+
+    inline FloatLanes operator+(FloatLanes a, FloatLanes b) { return { _mm256_add_ps(a.v, b.v) }; }
+    inline FloatLanes operator-(FloatLanes a, FloatLanes b) { return { _mm256_sub_ps(a.v, b.v) }; }
+    inline FloatLanes operator*(FloatLanes a, FloatLanes b) { return { _mm256_mul_ps(a.v, b.v) }; }
+    inline FloatLanes operator/(FloatLanes a, FloatLanes b) { return { _mm256_div_ps(a.v, b.v) }; }
+
+    inline FloatLanes Min(FloatLanes a, FloatLanes b) { return { _mm256_min_ps(a.v, b.v) }; }
+    inline FloatLanes Max(FloatLanes a, FloatLanes b) { return { _mm256_max_ps(a.v, b.v) }; }
+    inline FloatLanes Sqrt(FloatLanes a) { return { _mm256_sqrt_ps(a.v) }; }
+    inline FloatLanes Abs(FloatLanes a) { return { _mm256_andnot_ps(_mm256_set1_ps(-0.f), a.v) }; }
+
+    // Comparisons return all-ones lanes where the predicate holds
+    inline FloatLanes Greater(FloatLanes a, FloatLanes b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ) }; }
+    inline FloatLanes Less(FloatLanes a, FloatLanes b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ) }; }
+    inline FloatLanes GreaterEqual(FloatLanes a, FloatLanes b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ) }; }
+    inline FloatLanes And(FloatLanes a, FloatLanes b) { return { _mm256_and_ps(a.v, b.v) }; }
+    inline FloatLanes Or(FloatLanes a, FloatLanes b) { return { _mm256_or_ps(a.v, b.v) }; }
+    inline FloatLanes Select(FloatLanes mask, FloatLanes a, FloatLanes b) { return { _mm256_blendv_ps(b.v, a.v, mask.v) }; }
+
+    // One bit per lane, lane 0 in the lowest bit
+    inline uint32_t MaskBits(FloatLanes mask) { return static_cast<uint32_t>(_mm256_movemask_ps(mask.v)); }
+#elif defined(BEZIER_SIMD_SSE)
+    inline FloatLanes Set1(float value) { return { _mm_set1_ps(value) }; }
+    inline FloatLanes Load(float const* src) { return { _mm_load_ps(src) }; }
+    inline FloatLanes LoadUnaligned(float const* src) { return { _mm_loadu_ps(src) }; }
+    inline void Store(float* dst, FloatLanes a) { _mm_store_ps(dst, a.v); }
+    inline void StoreUnaligned(float* dst, FloatLanes a) { _mm_storeu_ps(dst, a.v); }
+
+    // Width unsigned 16 bit integers as floats, src needn't be aligned
+    inline FloatLanes LoadUInt16(uint16_t const* src) { return { _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<__m128i const*>(src)), _mm_setzero_si128())) }; }
+
+    inline FloatLanes operator+(FloatLanes a, FloatLanes b) { return { _mm_add_ps(a.v, b.v) }; }
+    inline FloatLanes operator-(FloatLanes a, FloatLanes b) { return { _mm_sub_ps(a.v, b.v) }; }
+    inline FloatLanes operator*(FloatLanes a, FloatLanes b) { return { _mm_mul_ps(a.v, b.v) }; }
+    inline FloatLanes operator/(FloatLanes a, FloatLanes b) { return { _mm_div_ps(a.v, b.v) }; }
+
+    inline FloatLanes Min(FloatLanes a, FloatLanes b) { return { _mm_min_ps(a.v, b.v) }; }
+    inline FloatLanes Max(FloatLanes a, FloatLanes b) { return { _mm_max_ps(a.v, b.v) }; }
+    inline FloatLanes Sqrt(FloatLanes a) { return { _mm_sqrt_ps(a.v) }; }
+    inline FloatLanes Abs(FloatLanes a) { return { _mm_andnot_ps(_mm_set1_ps(-0.f), a.v) }; }
+
+    // Comparisons return all-ones lanes where the predicate holds
+    inline FloatLanes Greater(FloatLanes a, FloatLanes b) { return { _mm_cmpgt_ps(a.v, b.v) }; }
+    inline FloatLanes Less(FloatLanes a, FloatLanes b) { return { _mm_cmplt_ps(a.v, b.v) }; }
+    inline FloatLanes GreaterEqual(FloatLanes a, FloatLanes b) { return { _mm_cmpge_ps(a.v, b.v) }; }
+    inline FloatLanes And(FloatLanes a, FloatLanes b) { return { _mm_and_ps(a.v, b.v) }; }
+    inline FloatLanes Or(FloatLanes a, FloatLanes b) { return { _mm_or_ps(a.v, b.v) }; }
+
+    // SSE2 has no blend instruction
+    inline FloatLanes Select(FloatLanes mask, FloatLanes a, FloatLanes b) { return { _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)) }; }
+
+    // One bit per lane, lane 0 in the lowest bit
+    inline uint32_t MaskBits(FloatLanes mask) { return static_cast<uint32_t>(_mm_movemask_ps(mask.v)); }
+#else
+    inline FloatLanes Set1(float value) { return { value }; }
+    inline FloatLanes Load(float const* src) { return { *src }; }
+    inline FloatLanes LoadUnaligned(float const* src) { return { *src }; }
+    inline void Store(float* dst, FloatLanes a) { *dst = a.v; }
+    inline void StoreUnaligned(float* dst, FloatLanes a) { *dst = a.v; }
+    inline FloatLanes LoadUInt16(uint16_t const* src) { return { float(*src) }; }
+
+    inline FloatLanes operator+(FloatLanes a, FloatLanes b) { return { a.v + b.v }; }
+    inline FloatLanes operator-(FloatLanes a, FloatLanes b) { return { a.v - b.v }; }
+    inline FloatLanes operator*(FloatLanes a, FloatLanes b) { return { a.v * b.v }; }
+    inline FloatLanes operator/(FloatLanes a, FloatLanes b) { return { a.v / b.v }; }
+
+    inline FloatLanes Min(FloatLanes a, FloatLanes b) { return { a.v < b.v ? a.v : b.v }; }
+    inline FloatLanes Max(FloatLanes a, FloatLanes b) { return { a.v > b.v ? a.v : b.v }; }
+    inline FloatLanes Sqrt(FloatLanes a) { return { std::sqrt(a.v) }; }
+    inline FloatLanes Abs(FloatLanes a) { return { std::fabs(a.v) }; }
+
+    // Masks are kept as 1.f/0.f in the scalar fallback
+    inline FloatLanes Greater(FloatLanes a, FloatLanes b) { return { a.v > b.v ? 1.f : 0.f }; }
+    inline FloatLanes Less(FloatLanes a, FloatLanes b) { return { a.v < b.v ? 1.f : 0.f }; }
+    inline FloatLanes GreaterEqual(FloatLanes a, FloatLanes b) { return { a.v >= b.v ? 1.f : 0.f }; }
+    inline FloatLanes And(FloatLanes a, FloatLanes b) { return { (a.v != 0.f && b.v != 0.f) ? 1.f : 0.f }; }
+    inline FloatLanes Or(FloatLanes a, FloatLanes b) { return { (a.v != 0.f || b.v != 0.f) ? 1.f : 0.f }; }
+    inline FloatLanes Select(FloatLanes mask, FloatLanes a, FloatLanes b) { return { mask.v != 0.f ? a.v : b.v }; }
+
+    inline uint32_t MaskBits(FloatLanes mask) { return mask.v != 0.f ? 1u : 0u; }
+#endif
+
+    inline FloatLanes MulAdd(FloatLanes a, FloatLanes b, FloatLanes c) { return a * b + c; }
+
+    // Component-wise 3D vectors over lanes
+    struct Vector3Lanes
+    {
+        FloatLanes x, y, z;
+    };
+
+    inline Vector3Lanes operator+(Vector3Lanes const& a, Vector3Lanes const& b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+    inline Vector3Lanes operator-(Vector3Lanes const& a, Vector3Lanes const& b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+    inline Vector3Lanes operator*(Vector3Lanes const& a, FloatLanes s) { return { a.x * s, a.y * s, a.z * s }; }
+
+    inline FloatLanes Dot(Vector3Lanes const& a, Vector3Lanes const& b)
+    {
+        return a.x * b.x + a.y * b.y + a.z * b.z;
+    }
+
+    inline Vector3Lanes Cross(Vector3Lanes const& a, Vector3Lanes const& b)
+    {
+        return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+    }
+
+    // Same contract as XMVector3Normalize, zero length vectors stay zero
+    inline Vector3Lanes Normalize(Vector3Lanes const& a)
+    {
+        FloatLanes const zero = Set1(0.f);
+        FloatLanes const length = Sqrt(Dot(a, a));
+        FloatLanes const nonZero = Greater(length, zero);
+        FloatLanes const safeLength = Select(nonZero, length, Set1(1.f));
+
+        return { Select(nonZero, a.x / safeLength, zero), Select(nonZero, a.y / safeLength, zero), Select(nonZero, a.z / safeLength, zero) };
+    }
+
+    // Cache line alignment for containers that are streamed through registers
+    static constexpr size_t CacheLineAlignment = 64;
+
+    // Allocator that aligns the whole block, so Load and Store can be used from the first element
+    template<typename T, size_t Alignment = CacheLineAlignment>
+    struct AlignedAllocator
+    {
+        using value_type = T;
+
+        template<typename U>
+        struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+        AlignedAllocator() = default;
+
+        template<typename U>
+        AlignedAllocator(AlignedAllocator<U, Alignment> const&) {}
+
+        T* allocate(size_t count)
+        {
+            return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+        }
+
+        void deallocate(T* pointer, size_t)
+        {
+            ::operator delete(pointer, std::align_val_t(Alignment));
+        }
+
+        template<typename U>
+        bool operator==(AlignedAllocator<U, Alignment> const&) const { return true; }
+
+        template<typename U>
+        bool operator!=(AlignedAllocator<U, Alignment> const&) const { return false; }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+
+#include "BezierMaths.h"
+
+namespace BezierMaths
+{
+    // One de Casteljau level in place, the degree level patch in points becomes a degree level - 1 patch at the front of the array
+    // Rows are laid out like TriangularIndex, row r starts at r(r+1)/2 and holds the r + 1 points with j = level - r
+    template<unsigned N>
+    void DecasteljauLevel(ControlPoint (&points)[BezierTriangle<N>::NumControlPoints], unsigned level, DirectX::SimpleMath::Vector3 const& uvw)
+    {
+        for (unsigned row = 0; row < level; ++row)
+        {
+            unsigned const rowStart = row * (row + 1) / 2;
+            unsigned const nextRowStart = (row + 1) * (row + 2) / 2;
+            for (unsigned k = 0; k <= row; ++k)
+            {
+                points[rowStart + k] = points[nextRowStart + k] * uvw.x + points[rowStart + k] * uvw.y + points[nextRowStart + k + 1] * uvw.z;
+            }
+        }
+    }
+
+    // The part of patch over the domain triangle with corners a, b and c, reparameterised so a is its i corner, b its j corner and c its k corner
+    // Control point (i, j, k) is the blossom of the patch at a i times, b j times and c k times, so the result is exact up to rounding
+    // Corners don't have to be inside the patch, corners outside extrapolate it
+    template<unsigned N>
+    BezierTriangle<N> Reparameterise(BezierTriangle<N> const& patch, DirectX::SimpleMath::Vector3 const& a, DirectX::SimpleMath::Vector3 const& b, DirectX::SimpleMath::Vector3 const& c)
+    {
+        constexpr unsigned NumControlPoints = BezierTriangle<N>::NumControlPoints;
+
+        BezierTriangle<N> result;
+
+        // Levels taken at a are shared by every control point with at least that many, the same goes for b within one i
+        ControlPoint atA[NumControlPoints], atB[NumControlPoints], atC[NumControlPoints];
+        std::copy_n(patch.ControlPoints, NumControlPoints, atA);
+        for (unsigned i = 0; i <= N; ++i)
+        {
+            if (i > 0)
+            {
+                DecasteljauLevel<N>(atA, N - i + 1, a);
+            }
+
+            std::copy_n(atA, NumControlPoints, atB);
+            for (unsigned j = 0; i + j <= N; ++j)
+            {
+                if (j > 0)
+                {
+                    DecasteljauLevel<N>(atB, N - i - j + 1, b);
+                }
+
+                unsigned const k = N - i - j;
+                std::copy_n(atB, NumControlPoints, atC);
+                for (unsigned level = k; level > 0; --level)
+                {
+                    DecasteljauLevel<N>(atC, level, c);
+                }
+
+                result.ControlPoints[TriangularIndex<N>::To1D(j, k)] = atC[0];
+            }
+        }
+
+        return result;
+    }
+
+    // Splits patch 1-to-3 at the barycentric point uvw, reading the sub-patches off the edges of the de Casteljau pyramid
+    // out[0] covers (uvw, j corner, k corner), out[1] covers (i corner, uvw, k corner) and out[2] covers (i corner, j corner, uvw),
+    // each with uvw in the place of the corner it replaces so all three keep the patch's orientation
+    // uvw on an edge gives one degenerate sub-patch
+    template<unsigned N>
+    void Subdivide(BezierTriangle<N> const& patch, DirectX::SimpleMath::Vector3 const& uvw, BezierTriangle<N> (&out)[3])
+    {
+        constexpr unsigned NumControlPoints = BezierTriangle<N>::NumControlPoints;
+
+        // Level r of the pyramid is the blossom at uvw r times, its i = 0, j = 0 and k = 0 edges are the r-th rows of the three sub-patches
+        ControlPoint points[NumControlPoints];
+        std::copy_n(patch.ControlPoints, NumControlPoints, points);
+        for (unsigned r = 0; r <= N; ++r)
+        {
+            if (r > 0)
+            {
+                DecasteljauLevel<N>(points, N - r + 1, uvw);
+            }
+
+            unsigned const level = N - r;
+            for (unsigned row = 0; row <= level; ++row)
+            {
+                unsigned const rowStart = row * (row + 1) / 2;
+                out[0].ControlPoints[TriangularIndex<N>::To1D(level - row, row)] = points[rowStart + row];
+                out[1].ControlPoints[TriangularIndex<N>::To1D(r, row)] = points[level * (level + 1) / 2 + row];
+                out[2].ControlPoints[TriangularIndex<N>::To1D(level - row, r)] = points[rowStart];
+            }
+        }
+    }
+
+    // Splits patch 1-to-4 at its edge midpoints
+    // out[0], out[1] and out[2] hold the i, j and k corners, out[3] is the middle triangle, turned half way round so it keeps the patch's orientation
+    template<unsigned N>
+    void Subdivide(BezierTriangle<N> const& patch, BezierTriangle<N> (&out)[4])
+    {
+        using DirectX::SimpleMath::Vector3;
+
+        Vector3 const cornerI(1.f, 0.f, 0.f), cornerJ(0.f, 1.f, 0.f), cornerK(0.f, 0.f, 1.f);
+        Vector3 const middleIJ(0.5f, 0.5f, 0.f), middleJK(0.f, 0.5f, 0.5f), middleKI(0.5f, 0.f, 0.5f);
+
+        out[0] = Reparameterise(patch, cornerI, middleIJ, middleKI);
+        out[1] = Reparameterise(patch, middleIJ, cornerJ, middleJK);
+        out[2] = Reparameterise(patch, middleKI, middleJK, cornerK);
+        out[3] = Reparameterise(patch, middleJK, middleKI, middleIJ);
+    }
+}
\ No newline at end of file
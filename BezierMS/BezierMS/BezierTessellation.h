@@ -0,0 +1,770 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <iterator>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+#include <limits>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "BezierMaths.h"
+#include "BezierSimd.h"
+#include "ThreadPool.h"
+
+namespace BezierMaths
+{
+    // Number of vertices in a tessellation grid, row r holds r + 1 vertices
+    constexpr unsigned NumGridVertices(unsigned numRows)
+    {
+        return (numRows + 1) * (numRows + 2) / 2;
+    }
+
+    // Row counts come in through TessellationOptions at runtime, so bad ones throw in release builds too
+    inline void CheckNumRows(unsigned numRows)
+    {
+        if (numRows == 0)
+        {
+            throw std::invalid_argument("A tessellation needs at least one row.");
+        }
+    }
+
+    // Throws if a grid of numRows rows has more vertices than Index can address, 16 bit indices stop at 360 rows
+    template<typename Index>
+    void CheckIndexRange(unsigned numRows)
+    {
+        CheckNumRows(numRows);
+        uint64_t const numVertices = (uint64_t(numRows) + 1) * (uint64_t(numRows) + 2) / 2;
+        if (numVertices - 1 > (std::numeric_limits<Index>::max)())
+        {
+            throw std::length_error(std::to_string(numRows) + " rows need more vertices than a " + std::to_string(sizeof(Index) * 8) + " bit index can address.");
+        }
+    }
+
+    constexpr unsigned GridVertexIndex(unsigned row, unsigned column)
+    {
+        return row * (row + 1) / 2 + column;
+    }
+
+    // Barycentric coordinate of a grid vertex, matches the row layout the mesh shader uses
+    inline DirectX::SimpleMath::Vector3 GridVertexUVW(unsigned numRows, unsigned row, unsigned column)
+    {
+        float const step = 1.f / numRows;
+        return { (row - column) * step, 1.f - row * step, column * step };
+    }
+
+    // Bernstein weights of every control point at every vertex of a tessellation grid
+    // Tangent and BiTangent hold the weights of p100 - p010 and p001 - p010 from the last de Casteljau level, which Evaluate builds the normal from
+    // Weights are stored per control point with vertices contiguous(and padded to the register width) so the product runs across vertices
+    struct BernsteinBasis
+    {
+        unsigned Degree = 0;
+        unsigned NumRows = 0;
+        unsigned NumVertices = 0;
+        unsigned NumControlPoints = 0;
+        unsigned Stride = 0;
+
+        std::vector<float> Position;
+        std::vector<float> Tangent;
+        std::vector<float> BiTangent;
+
+        float const* PositionWeights(unsigned controlPoint) const { return &Position[controlPoint * Stride]; }
+        float const* TangentWeights(unsigned controlPoint) const { return &Tangent[controlPoint * Stride]; }
+        float const* BiTangentWeights(unsigned controlPoint) const { return &BiTangent[controlPoint * Stride]; }
+    };
+
+    // Trinomial Bernstein polynomial of degree n, evaluated in double so the table carries no extra rounding
+    inline double Bernstein(unsigned n, int i, int j, int k, double u, double v, double w)
+    {
+        if (i < 0 || j < 0 || k < 0)
+        {
+            return 0.0;
+        }
+
+        double coefficient = 1.0;
+        for (unsigned f = 2; f <= n; ++f) coefficient *= f;
+        for (int f = 2; f <= i; ++f) coefficient /= f;
+        for (int f = 2; f <= j; ++f) coefficient /= f;
+        for (int f = 2; f <= k; ++f) coefficient /= f;
+
+        double result = coefficient;
+        for (int p = 0; p < i; ++p) result *= u;
+        for (int p = 0; p < j; ++p) result *= v;
+        for (int p = 0; p < k; ++p) result *= w;
+
+        return result;
+    }
+
+    template<unsigned N>
+    std::shared_ptr<BernsteinBasis const> BuildBernsteinBasis(unsigned numRows)
+    {
+        static_assert(N >= 1, "Patch must be at least linear.");
+        constexpr unsigned Width = Simd::FloatLanes::Width;
+
+        auto basis = std::make_shared<BernsteinBasis>();
+        basis->Degree = N;
+        basis->NumRows = numRows;
+        basis->NumVertices = NumGridVertices(numRows);
+        basis->NumControlPoints = BezierTriangle<N>::NumControlPoints;
+        basis->Stride = (basis->NumVertices + Width - 1) / Width * Width;
+
+        size_t const tableSize = size_t(basis->Stride) * basis->NumControlPoints;
+        basis->Position.assign(tableSize, 0.f);
+        basis->Tangent.assign(tableSize, 0.f);
+        basis->BiTangent.assign(tableSize, 0.f);
+
+        for (unsigned cp = 0; cp < basis->NumControlPoints; ++cp)
+        {
+            auto const idx = TriangularIndex<N>::From1D(cp);
+            int const i = idx.i, j = idx.j, k = idx.k;
+
+            for (unsigned row = 0; row <= numRows; ++row)
+            {
+                for (unsigned column = 0; column <= row; ++column)
+                {
+                    double const u = double(row - column) / numRows;
+                    double const v = double(numRows - row) / numRows;
+                    double const w = double(column) / numRows;
+
+                    // Weights of this control point in the three points of the last(linear) de Casteljau level
+                    double const p100 = Bernstein(N - 1, i - 1, j, k, u, v, w);
+                    double const p010 = Bernstein(N - 1, i, j - 1, k, u, v, w);
+                    double const p001 = Bernstein(N - 1, i, j, k - 1, u, v, w);
+
+                    size_t const entry = size_t(cp) * basis->Stride + GridVertexIndex(row, column);
+                    basis->Position[entry] = static_cast<float>(Bernstein(N, i, j, k, u, v, w));
+                    basis->Tangent[entry] = static_cast<float>(p100 - p010);
+                    basis->BiTangent[entry] = static_cast<float>(p001 - p010);
+                }
+            }
+        }
+
+        return basis;
+    }
+
+    // Tables are built on first use and shared between every patch of degree N tessellated with the same row count
+    template<unsigned N>
+    std::shared_ptr<BernsteinBasis const> GetBernsteinBasis(unsigned numRows)
+    {
+        CheckNumRows(numRows);
+
+        static std::mutex cacheMutex;
+        static std::unordered_map<unsigned, std::shared_ptr<BernsteinBasis const>> cache;
+
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        auto& entry = cache[numRows];
+        if (!entry)
+        {
+            entry = BuildBernsteinBasis<N>(numRows);
+        }
+
+        return entry;
+    }
+
+    // Row count template argument for tessellators that take the count at runtime
+    static constexpr unsigned DynamicRows = 0;
+
+    // Row counts with their own instantiation, their loop bounds are compile time constants so the inner loops can be fully unrolled
+    template<typename Function>
+    decltype(auto) DispatchRowCount(unsigned numRows, Function&& function)
+    {
+        switch (numRows)
+        {
+        case 4: return function(std::integral_constant<unsigned, 4>{});
+        case 8: return function(std::integral_constant<unsigned, 8>{});
+        case 16: return function(std::integral_constant<unsigned, 16>{});
+        case 32: return function(std::integral_constant<unsigned, 32>{});
+        case 64: return function(std::integral_constant<unsigned, 64>{});
+        default: return function(std::integral_constant<unsigned, DynamicRows>{});
+        }
+    }
+
+    struct TessellationOptions
+    {
+        // Same meaning as NumTesselationRowsPerPatch in the shader constants, a patch is split into NumRows * NumRows triangles
+        unsigned NumRows = 16;
+    };
+
+    // Evaluates every grid vertex as a dense product of the control points against the cached weights
+    // O(N^2) per vertex instead of the O(N^3) de Casteljau pyramid, results match Evaluate to float rounding
+    template<unsigned N, unsigned Rows = DynamicRows>
+    void EvaluateGrid(BezierTriangle<N> const& patch, BernsteinBasis const& basis, Vertex* out)
+    {
+        using namespace Simd;
+        constexpr unsigned Width = FloatLanes::Width;
+        constexpr unsigned NumControlPoints = BezierTriangle<N>::NumControlPoints;
+
+        unsigned numVertices = basis.NumVertices;
+        if constexpr (Rows != DynamicRows)
+        {
+            assert(basis.NumRows == Rows);
+            numVertices = NumGridVertices(Rows);
+        }
+
+        for (unsigned first = 0; first < numVertices; first += Width)
+        {
+            Vector3Lanes position = { Set1(0.f), Set1(0.f), Set1(0.f) };
+            Vector3Lanes tangent = position;
+            Vector3Lanes biTangent = position;
+
+            for (unsigned cp = 0; cp < NumControlPoints; ++cp)
+            {
+                ControlPoint const& point = patch.ControlPoints[cp];
+                Vector3Lanes const p = { Set1(point.x), Set1(point.y), Set1(point.z) };
+
+                position = position + p * LoadUnaligned(basis.PositionWeights(cp) + first);
+                tangent = tangent + p * LoadUnaligned(basis.TangentWeights(cp) + first);
+                biTangent = biTangent + p * LoadUnaligned(basis.BiTangentWeights(cp) + first);
+            }
+
+            Vector3Lanes const normal = Normalize(Cross(Normalize(tangent), Normalize(biTangent)));
+
+            float lanes[6][Width];
+            StoreUnaligned(lanes[0], position.x);
+            StoreUnaligned(lanes[1], position.y);
+            StoreUnaligned(lanes[2], position.z);
+            StoreUnaligned(lanes[3], normal.x);
+            StoreUnaligned(lanes[4], normal.y);
+            StoreUnaligned(lanes[5], normal.z);
+
+            unsigned const count = (std::min)(Width, numVertices - first);
+            for (unsigned lane = 0; lane < count; ++lane)
+            {
+                out[first + lane] = { { lanes[0][lane], lanes[1][lane], lanes[2][lane] }, { lanes[3][lane], lanes[4][lane], lanes[5][lane] } };
+            }
+        }
+    }
+
+    // Single grid vertex from the cached weights, for callers that only need part of the grid
+    template<unsigned N>
+    Vertex EvaluateGridVertex(BezierTriangle<N> const& patch, BernsteinBasis const& basis, unsigned gridIndex)
+    {
+        using Vector3 = DirectX::SimpleMath::Vector3;
+
+        Vector3 position, tangent, biTangent;
+        for (unsigned cp = 0; cp < BezierTriangle<N>::NumControlPoints; ++cp)
+        {
+            position += patch.ControlPoints[cp] * basis.PositionWeights(cp)[gridIndex];
+            tangent += patch.ControlPoints[cp] * basis.TangentWeights(cp)[gridIndex];
+            biTangent += patch.ControlPoints[cp] * basis.BiTangentWeights(cp)[gridIndex];
+        }
+
+        tangent.Normalize();
+        biTangent.Normalize();
+
+        auto normal = tangent.Cross(biTangent);
+        normal.Normalize();
+        return { position, normal };
+    }
+
+    // Writes basis.NumRows * basis.NumRows triangles to out, grid needs room for basis.NumVertices vertices
+    // Returns one past the last triangle written
+    template<unsigned N, unsigned Rows>
+    Triangle* TessellateGrid(BezierTriangle<N> const& patch, BernsteinBasis const& basis, Vertex* grid, Triangle* out)
+    {
+        unsigned numRows = basis.NumRows;
+        if constexpr (Rows != DynamicRows)
+        {
+            numRows = Rows;
+        }
+
+        EvaluateGrid<N, Rows>(patch, basis, grid);
+
+        for (unsigned row = 0; row < numRows; ++row)
+        {
+            Vertex const* top = &grid[GridVertexIndex(row, 0)];
+            Vertex const* bot = &grid[GridVertexIndex(row + 1, 0)];
+
+            // Same strip order as before, every second triangle in a row is inverted
+            for (unsigned column = 0; column <= row; ++column)
+            {
+                *out++ = { bot[column], top[column], bot[column + 1] };
+                if (column < row)
+                {
+                    *out++ = { top[column], top[column + 1], bot[column + 1] };
+                }
+            }
+        }
+
+        return out;
+    }
+
+    // Tessellates a run of patches into one buffer, patch i owns triangles [i * NumRows * NumRows, (i + 1) * NumRows * NumRows)
+    template<unsigned N, unsigned Rows>
+    void TessellatePatches(Span<BezierTriangle<N> const> patches, BernsteinBasis const& basis, Triangle* out)
+    {
+        std::vector<Vertex> grid(basis.NumVertices);
+        for (auto const& patch : patches)
+        {
+            out = TessellateGrid<N, Rows>(patch, basis, grid.data(), out);
+        }
+    }
+
+    template<unsigned N>
+    std::vector<Triangle> TessellatePatch(BezierTriangle<N> const& patch, TessellationOptions const& options = {})
+    {
+        CheckNumRows(options.NumRows);
+        auto const basis = GetBernsteinBasis<N>(options.NumRows);
+
+        // Use sum of arithemetic series to detrmine the total size
+        // Turns out the sum of series = n*n
+        std::vector<Triangle> result(options.NumRows * options.NumRows);
+
+        DispatchRowCount(options.NumRows, [&](auto rows) { TessellatePatches<N, decltype(rows)::value>({ &patch, 1 }, *basis, result.data()); });
+        return result;
+    }
+
+    // Vertex buffer plus three indices per triangle
+    template<typename Index>
+    struct IndexedMesh
+    {
+        static_assert(std::is_same_v<Index, uint16_t> || std::is_same_v<Index, uint32_t>, "Index buffers are either 16 or 32 bit.");
+
+        std::vector<Vertex> Vertices;
+        std::vector<Index> Indices;
+    };
+
+    // Writes the indices of a row grid in the same triangle order as TessellatePatch, returns one past the last index written
+    template<typename Index>
+    Index* WriteGridIndices(unsigned numRows, Index baseVertex, Index* out)
+    {
+        for (unsigned row = 0; row < numRows; ++row)
+        {
+            Index const top = static_cast<Index>(baseVertex + GridVertexIndex(row, 0));
+            Index const bot = static_cast<Index>(baseVertex + GridVertexIndex(row + 1, 0));
+
+            for (unsigned column = 0; column <= row; ++column)
+            {
+                *out++ = static_cast<Index>(bot + column);
+                *out++ = static_cast<Index>(top + column);
+                *out++ = static_cast<Index>(bot + column + 1);
+
+                if (column < row)
+                {
+                    *out++ = static_cast<Index>(top + column);
+                    *out++ = static_cast<Index>(top + column + 1);
+                    *out++ = static_cast<Index>(bot + column + 1);
+                }
+            }
+        }
+
+        return out;
+    }
+
+    // Evaluates each grid vertex once instead of once per triangle that touches it
+    // At 16 rows that is 153 vertices and 768 indices in place of 768 full vertices
+    template<unsigned N, typename Index, unsigned Rows>
+    IndexedMesh<Index> TessellateGridIndexed(BezierTriangle<N> const& patch, unsigned numRows)
+    {
+        if constexpr (Rows != DynamicRows)
+        {
+            numRows = Rows;
+            static_assert(NumGridVertices(Rows) - 1 <= (std::numeric_limits<Index>::max)(), "Grid has more vertices than the index type can address.");
+        }
+
+        CheckIndexRange<Index>(numRows);
+        auto const basis = GetBernsteinBasis<N>(numRows);
+
+        IndexedMesh<Index> result;
+        result.Vertices.resize(basis->NumVertices);
+        result.Indices.resize(numRows * numRows * 3);
+
+        EvaluateGrid<N, Rows>(patch, *basis, result.Vertices.data());
+        WriteGridIndices<Index>(numRows, 0, result.Indices.data());
+
+        return result;
+    }
+
+    template<unsigned N, typename Index = uint32_t>
+    IndexedMesh<Index> TessellatePatchIndexed(BezierTriangle<N> const& patch, TessellationOptions const& options = {})
+    {
+        return DispatchRowCount(options.NumRows, [&](auto rows) { return TessellateGridIndexed<N, Index, decltype(rows)::value>(patch, options.NumRows); });
+    }
+
+    template<unsigned N, unsigned M>
+    std::vector<Triangle> TessellateShape(BezierShape<N, M> const& shape, TessellationOptions const& options = {})
+    {
+        CheckNumRows(options.NumRows);
+        auto const basis = GetBernsteinBasis<N>(options.NumRows);
+
+        // Every patch has the same triangle count so the whole shape is allocated once
+        std::vector<Triangle> result(M * size_t(options.NumRows) * options.NumRows);
+
+        DispatchRowCount(options.NumRows, [&](auto rows) { TessellatePatches<N, decltype(rows)::value>({ shape.Patches, M }, *basis, result.data()); });
+        return result;
+    }
+
+    // Same output as TessellateShape, patches are split across the pool and each task writes its own slice of the buffer
+    // Slices are fixed by patch index so the triangle order doesn't depend on scheduling
+    template<unsigned N, unsigned M>
+    std::vector<Triangle> TessellateShapeParallel(BezierShape<N, M> const& shape, ThreadPool& pool, TessellationOptions const& options = {})
+    {
+        CheckNumRows(options.NumRows);
+        auto const basis = GetBernsteinBasis<N>(options.NumRows);
+
+        size_t const trisPerPatch = size_t(options.NumRows) * options.NumRows;
+        std::vector<Triangle> result(M * trisPerPatch);
+
+        // Aim for a few thousand triangles per task so small row counts don't drown in scheduling overhead
+        size_t const grainSize = (std::max)(size_t(1), size_t(4096) / trisPerPatch);
+
+        DispatchRowCount(options.NumRows, [&](auto rows)
+        {
+            pool.ParallelFor(M, grainSize, [&](size_t begin, size_t end)
+            {
+                TessellatePatches<N, decltype(rows)::value>({ shape.Patches + begin, end - begin }, *basis, result.data() + begin * trisPerPatch);
+            });
+        });
+
+        return result;
+    }
+
+    // Control points closer than the weld tolerance hash to the same cell, points that straddle a cell boundary won't weld
+    inline int64_t QuantizeForWeld(float value, float tolerance)
+    {
+        return static_cast<int64_t>(std::llround(double(value) / tolerance));
+    }
+
+    // FNV-1a over quantized coordinates
+    template<size_t Size>
+    struct WeldKeyHash
+    {
+        size_t operator()(std::array<int64_t, Size> const& key) const
+        {
+            uint64_t hash = 14695981039346656037ull;
+            for (int64_t value : key)
+            {
+                hash = (hash ^ static_cast<uint64_t>(value)) * 1099511628211ull;
+            }
+
+            return static_cast<size_t>(hash);
+        }
+    };
+
+    // Tessellates patches into one indexed mesh where neighbouring patches share their boundary vertices
+    // A patch boundary is a Bezier curve of the N + 1 control points along it, so two patches whose edge control points match(in either direction)
+    // meet exactly along that edge, the same goes for corners
+    // Shared vertices are evaluated once, by the first patch that touches them, and every other patch indexes that vertex, so no cracks can open
+    // and no boundary work is repeated. The first patch's normal is used on shared vertices, which is exact for patches that join smoothly
+    template<unsigned N>
+    IndexedMesh<uint32_t> TessellatePatchesWelded(Span<BezierTriangle<N> const> patches, TessellationOptions const& options = {}, float weldTolerance = 1e-5f)
+    {
+        static constexpr unsigned NumEdgeControlPoints = N + 1;
+        using CornerKey = std::array<int64_t, 3>;
+        using EdgeKey = std::array<int64_t, 3 * NumEdgeControlPoints>;
+
+        CheckNumRows(options.NumRows);
+        unsigned const numRows = options.NumRows;
+        auto const basis = GetBernsteinBasis<N>(numRows);
+
+        // Edge e of the grid, walked from its first corner, at step s
+        // Edge 0 is w = 0 (first column), edge 1 is u = 0 (last column), edge 2 is v = 0 (last row)
+        auto const edgeGridIndex = [numRows](unsigned edge, unsigned step)
+        {
+            return edge == 0 ? GridVertexIndex(step, 0) : edge == 1 ? GridVertexIndex(step, step) : GridVertexIndex(numRows, step);
+        };
+
+        // Control points of the same edge, in the same direction
+        auto const edgeControlPoint = [](unsigned edge, unsigned step)
+        {
+            return edge == 0 ? GridVertexIndex(step, 0) : edge == 1 ? GridVertexIndex(step, step) : GridVertexIndex(N, step);
+        };
+
+        auto const cornerKey = [weldTolerance](ControlPoint const& point)
+        {
+            return CornerKey{ QuantizeForWeld(point.x, weldTolerance), QuantizeForWeld(point.y, weldTolerance), QuantizeForWeld(point.z, weldTolerance) };
+        };
+
+        std::unordered_map<CornerKey, uint32_t, WeldKeyHash<3>> corners;
+
+        // First vertex of the numRows - 1 interior vertices of each shared edge, stored in the edge's canonical direction
+        std::unordered_map<EdgeKey, uint32_t, WeldKeyHash<3 * NumEdgeControlPoints>> edges;
+
+        IndexedMesh<uint32_t> result;
+        result.Indices.resize(patches.Size * numRows * numRows * 3);
+
+        std::vector<uint32_t> gridToMesh(basis->NumVertices);
+        std::vector<uint32_t> gridIndices(numRows * numRows * 3);
+        WriteGridIndices<uint32_t>(numRows, 0, gridIndices.data());
+
+        uint32_t* outIndex = result.Indices.data();
+        for (auto const& patch : patches)
+        {
+            std::vector<bool> owned(basis->NumVertices, false);
+
+            // Reserves count new vertices and stores the first one in slot
+            auto const allocate = [&](uint32_t& slot, uint32_t count)
+            {
+                slot = static_cast<uint32_t>(result.Vertices.size());
+                result.Vertices.resize(result.Vertices.size() + count);
+            };
+
+            unsigned const cornerGrid[3] = { GridVertexIndex(0, 0), GridVertexIndex(numRows, 0), GridVertexIndex(numRows, numRows) };
+            unsigned const cornerControlPoint[3] = { GridVertexIndex(0, 0), GridVertexIndex(N, 0), GridVertexIndex(N, N) };
+            for (unsigned corner = 0; corner < 3; ++corner)
+            {
+                auto const inserted = corners.try_emplace(cornerKey(patch.ControlPoints[cornerControlPoint[corner]]), 0u);
+                if (inserted.second)
+                {
+                    allocate(inserted.first->second, 1);
+                    owned[cornerGrid[corner]] = true;
+                }
+
+                gridToMesh[cornerGrid[corner]] = inserted.first->second;
+            }
+
+            for (unsigned edge = 0; edge < 3; ++edge)
+            {
+                CornerKey const first = cornerKey(patch.ControlPoints[edgeControlPoint(edge, 0)]);
+                CornerKey const last = cornerKey(patch.ControlPoints[edgeControlPoint(edge, N)]);
+                bool const reversed = last < first;
+
+                EdgeKey key;
+                for (unsigned step = 0; step < NumEdgeControlPoints; ++step)
+                {
+                    CornerKey const point = cornerKey(patch.ControlPoints[edgeControlPoint(edge, reversed ? N - step : step)]);
+                    std::copy(point.begin(), point.end(), key.begin() + step * 3);
+                }
+
+                auto const inserted = edges.try_emplace(key, 0u);
+                if (inserted.second && numRows > 1)
+                {
+                    allocate(inserted.first->second, numRows - 1);
+                }
+
+                for (unsigned step = 1; step < numRows; ++step)
+                {
+                    unsigned const canonicalStep = reversed ? numRows - step : step;
+                    unsigned const gridIndex = edgeGridIndex(edge, step);
+
+                    gridToMesh[gridIndex] = inserted.first->second + canonicalStep - 1;
+                    owned[gridIndex] = inserted.second;
+                }
+            }
+
+            for (unsigned row = 2; row < numRows; ++row)
+            {
+                uint32_t first;
+                allocate(first, row - 1);
+                for (unsigned column = 1; column < row; ++column)
+                {
+                    unsigned const gridIndex = GridVertexIndex(row, column);
+                    gridToMesh[gridIndex] = first + column - 1;
+                    owned[gridIndex] = true;
+                }
+            }
+
+            for (unsigned gridIndex = 0; gridIndex < basis->NumVertices; ++gridIndex)
+            {
+                if (owned[gridIndex])
+                {
+                    result.Vertices[gridToMesh[gridIndex]] = EvaluateGridVertex(patch, *basis, gridIndex);
+                }
+            }
+
+            for (uint32_t gridIndex : gridIndices)
+            {
+                *outIndex++ = gridToMesh[gridIndex];
+            }
+        }
+
+        return result;
+    }
+
+    template<unsigned N, unsigned M>
+    IndexedMesh<uint32_t> TessellateShapeWelded(BezierShape<N, M> const& shape, TessellationOptions const& options = {}, float weldTolerance = 1e-5f)
+    {
+        return TessellatePatchesWelded<N>({ shape.Patches, M }, options, weldTolerance);
+    }
+
+    // Segment counts of the three patch edges and the row count of the interior
+    // Edge 0 is w = 0 (j to i corner), edge 1 is u = 0 (j to k corner), edge 2 is v = 0 (i to k corner), the same edges as the row grid
+    // Patches that share an edge must give it the same count, for example the larger of the two patches' row counts
+    struct EdgeTessellation
+    {
+        unsigned Edges[3] = { 16, 16, 16 };
+        unsigned Interior = 16;
+    };
+
+    // Point at canonical step of numSegments along the boundary curve through edgePoints
+    // The curve is walked from whichever end sorts first, so two patches sharing the edge run the exact same de Casteljau steps on
+    // the exact same floats and agree to the bit whatever direction they store the edge in
+    template<unsigned N>
+    ControlPoint EvaluateEdge(ControlPoint const (&edgePoints)[N + 1], unsigned step, unsigned numSegments)
+    {
+        auto const less = [](ControlPoint const& a, ControlPoint const& b)
+        {
+            return a.x != b.x ? a.x < b.x : (a.y != b.y ? a.y < b.y : a.z < b.z);
+        };
+
+        bool const reversed = std::lexicographical_compare(std::rbegin(edgePoints), std::rend(edgePoints), std::begin(edgePoints), std::end(edgePoints), less);
+
+        ControlPoint points[N + 1];
+        for (unsigned i = 0; i <= N; ++i)
+        {
+            points[i] = edgePoints[reversed ? N - i : i];
+        }
+
+        float const t = float(reversed ? numSegments - step : step) / numSegments;
+        for (unsigned level = N; level > 0; --level)
+        {
+            for (unsigned i = 0; i < level; ++i)
+            {
+                points[i] = points[i] * (1 - t) + points[i + 1] * t;
+            }
+        }
+
+        return points[0];
+    }
+
+    // Tessellates a patch with its own segment count on every edge, so patches with different densities meet without cracks
+    // The interior is the row grid of Interior rows with its outer ring removed, each edge is stitched to the matching side of what is
+    // left by walking both in step. Edge vertex positions come from EvaluateEdge, so they only depend on the shared edge control points
+    // Normals on an edge come from each patch's own surface, they only match across patches that join smoothly
+    // Triangles are wound the same way as the row grid
+    template<unsigned N, typename Index = uint32_t>
+    IndexedMesh<Index> TessellatePatchEdges(BezierTriangle<N> const& patch, EdgeTessellation const& tessellation)
+    {
+        using namespace DirectX::SimpleMath;
+        for (unsigned edge = 0; edge < 3; ++edge)
+        {
+            assert(tessellation.Edges[edge] > 0);
+        }
+
+        IndexedMesh<Index> result;
+
+        // Domain position of every vertex, used to fix the winding of stitched triangles
+        std::vector<Vector3> domain;
+        auto const addVertex = [&](Vector3 const& uvw, ControlPoint const* position)
+        {
+            Vertex vertex = Evaluate(patch, uvw);
+            if (position)
+            {
+                vertex.position = *position;
+            }
+
+            result.Vertices.push_back(vertex);
+            domain.push_back(uvw);
+            return static_cast<Index>(result.Vertices.size() - 1);
+        };
+
+        // Row grid winding is clockwise in (u, w)
+        auto const addTriangle = [&](Index a, Index b, Index c)
+        {
+            Vector3 const ab = domain[b] - domain[a];
+            Vector3 const ac = domain[c] - domain[a];
+            bool const clockwise = ab.x * ac.z - ab.z * ac.x < 0.f;
+
+            result.Indices.push_back(a);
+            result.Indices.push_back(clockwise ? b : c);
+            result.Indices.push_back(clockwise ? c : b);
+        };
+
+        Vector3 const cornerUVW[3] = { { 0.f, 1.f, 0.f }, { 1.f, 0.f, 0.f }, { 0.f, 0.f, 1.f } };
+        unsigned const cornerControlPoint[3] = { GridVertexIndex(0, 0), GridVertexIndex(N, 0), GridVertexIndex(N, N) };
+
+        // Corners j, i, k and the corners each edge runs between
+        unsigned const edgeCorners[3][2] = { { 0, 1 }, { 0, 2 }, { 1, 2 } };
+        auto const edgeControlPoint = [](unsigned edge, unsigned step)
+        {
+            return edge == 0 ? GridVertexIndex(step, 0) : edge == 1 ? GridVertexIndex(step, step) : GridVertexIndex(N, step);
+        };
+
+        Index corners[3];
+        for (unsigned corner = 0; corner < 3; ++corner)
+        {
+            corners[corner] = addVertex(cornerUVW[corner], &patch.ControlPoints[cornerControlPoint[corner]]);
+        }
+
+        // One triangle is all a patch with single segment edges and at most one row needs
+        if (tessellation.Interior <= 1 && tessellation.Edges[0] == 1 && tessellation.Edges[1] == 1 && tessellation.Edges[2] == 1)
+        {
+            addTriangle(corners[0], corners[1], corners[2]);
+            return result;
+        }
+
+        std::vector<Index> outer[3];
+        for (unsigned edge = 0; edge < 3; ++edge)
+        {
+            ControlPoint edgePoints[N + 1];
+            for (unsigned step = 0; step <= N; ++step)
+            {
+                edgePoints[step] = patch.ControlPoints[edgeControlPoint(edge, step)];
+            }
+
+            unsigned const numSegments = tessellation.Edges[edge];
+            Vector3 const& from = cornerUVW[edgeCorners[edge][0]];
+            Vector3 const& to = cornerUVW[edgeCorners[edge][1]];
+
+            outer[edge].push_back(corners[edgeCorners[edge][0]]);
+            for (unsigned step = 1; step < numSegments; ++step)
+            {
+                float const t = float(step) / numSegments;
+                ControlPoint const position = EvaluateEdge<N>(edgePoints, step, numSegments);
+                outer[edge].push_back(addVertex(from * (1 - t) + to * t, &position));
+            }
+
+            outer[edge].push_back(corners[edgeCorners[edge][1]]);
+        }
+
+        // Interior grid of the row grid without its outer ring, a single centre vertex when fewer than four rows are asked for
+        unsigned const numRows = (std::max)(tessellation.Interior, 3u);
+        unsigned const numInnerRows = numRows - 3;
+        float const step = 1.f / numRows;
+
+        Index const innerBase = static_cast<Index>(result.Vertices.size());
+        for (unsigned row = 0; row <= numInnerRows; ++row)
+        {
+            for (unsigned column = 0; column <= row; ++column)
+            {
+                addVertex({ (row - column + 1) * step, (numRows - row - 2) * step, (column + 1) * step }, nullptr);
+            }
+        }
+
+        size_t const numIndices = result.Indices.size();
+        result.Indices.resize(numIndices + numInnerRows * numInnerRows * 3);
+        WriteGridIndices<Index>(numInnerRows, innerBase, result.Indices.data() + numIndices);
+
+        // Sides of the inner grid in the same direction as the edges they face
+        std::vector<Index> inner[3];
+        for (unsigned i = 0; i <= numInnerRows; ++i)
+        {
+            inner[0].push_back(static_cast<Index>(innerBase + GridVertexIndex(i, 0)));
+            inner[1].push_back(static_cast<Index>(innerBase + GridVertexIndex(i, i)));
+            inner[2].push_back(static_cast<Index>(innerBase + GridVertexIndex(numInnerRows, i)));
+        }
+
+        // Walk each edge and its inner side together, always stepping along whichever next vertex is nearer the start
+        // Inner vertex i sits at (i + 1) / (numInnerRows + 2) along the side's direction
+        for (unsigned edge = 0; edge < 3; ++edge)
+        {
+            std::vector<Index> const& a = outer[edge];
+            std::vector<Index> const& b = inner[edge];
+            size_t const m = a.size() - 1, n = b.size() - 1;
+
+            size_t i = 0, j = 0;
+            while (i < m || j < n)
+            {
+                if (j == n || (i < m && (i + 1) * (n + 2) <= (j + 2) * m))
+                {
+                    addTriangle(a[i], a[i + 1], b[j]);
+                    ++i;
+                }
+                else
+                {
+                    addTriangle(a[i], b[j + 1], b[j]);
+                    ++j;
+                }
+            }
+        }
+
+        return result;
+    }
+}
\ No newline at end of file
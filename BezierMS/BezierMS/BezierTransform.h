@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstdint>
+#include <algorithm>
+
+#include "BezierMaths.h"
+#include "BezierSimd.h"
+#include "BezierPatchStore.h"
+
+namespace BezierMaths
+{
+    // Transforms a control point by the affine part of a D3D style row vector matrix
+    // Bezier patches are only invariant under affine maps, the projective column of the matrix is ignored
+    // Sums in the same order as the lane paths below, so a point comes out the same whichever path it takes
+    inline ControlPoint TransformPoint(ControlPoint const& point, DirectX::SimpleMath::Matrix const& transform)
+    {
+        auto const& m = transform.m;
+        return { point.x * m[0][0] + (point.y * m[1][0] + (point.z * m[2][0] + m[3][0])),
+                 point.x * m[0][1] + (point.y * m[1][1] + (point.z * m[2][1] + m[3][1])),
+                 point.x * m[0][2] + (point.y * m[1][2] + (point.z * m[2][2] + m[3][2])) };
+    }
+
+    // Rows of the matrix's affine part with each element broadcast, row[r][c] is m[r][c]
+    struct TransformLanes
+    {
+        explicit TransformLanes(DirectX::SimpleMath::Matrix const& transform)
+        {
+            for (unsigned row = 0; row < 4; ++row)
+            {
+                for (unsigned column = 0; column < 3; ++column)
+                {
+                    Rows[row][column] = Simd::Set1(transform.m[row][column]);
+                }
+            }
+        }
+
+        Simd::Vector3Lanes Apply(Simd::Vector3Lanes const& point) const
+        {
+            using Simd::MulAdd;
+
+            Simd::FloatLanes result[3];
+            for (unsigned axis = 0; axis < 3; ++axis)
+            {
+                result[axis] = MulAdd(point.x, Rows[0][axis], MulAdd(point.y, Rows[1][axis], MulAdd(point.z, Rows[2][axis], Rows[3][axis])));
+            }
+
+            return { result[0], result[1], result[2] };
+        }
+
+        Simd::FloatLanes Rows[4][3];
+    };
+
+    // Control points stored one after another in place, FloatLanes::Width points at a time
+    // Each register of points is split into x, y and z lanes, transformed and written back, the last partial register goes through TransformPoint
+    inline void Transform(Span<ControlPoint> points, DirectX::SimpleMath::Matrix const& transform)
+    {
+        using namespace Simd;
+        constexpr unsigned Width = FloatLanes::Width;
+
+        TransformLanes const lanesTransform(transform);
+
+        size_t const numFull = points.Size / Width * Width;
+        for (size_t first = 0; first < numFull; first += Width)
+        {
+            alignas(CacheLineAlignment) float lanes[3][Width];
+            for (unsigned lane = 0; lane < Width; ++lane)
+            {
+                lanes[0][lane] = points[first + lane].x;
+                lanes[1][lane] = points[first + lane].y;
+                lanes[2][lane] = points[first + lane].z;
+            }
+
+            Vector3Lanes const result = lanesTransform.Apply({ Load(lanes[0]), Load(lanes[1]), Load(lanes[2]) });
+            Store(lanes[0], result.x);
+            Store(lanes[1], result.y);
+            Store(lanes[2], result.z);
+
+            for (unsigned lane = 0; lane < Width; ++lane)
+            {
+                points[first + lane] = { lanes[0][lane], lanes[1][lane], lanes[2][lane] };
+            }
+        }
+
+        for (size_t point = numFull; point < points.Size; ++point)
+        {
+            points[point] = TransformPoint(points[point], transform);
+        }
+    }
+
+    template<unsigned N>
+    void Transform(BezierTriangle<N>& patch, DirectX::SimpleMath::Matrix const& transform)
+    {
+        Transform(Span<ControlPoint>(patch.ControlPoints, BezierTriangle<N>::NumControlPoints), transform);
+    }
+
+    // Every control point of every patch in place, the matrix is read once for the whole shape
+    template<unsigned N, unsigned M>
+    void Transform(BezierShape<N, M>& shape, DirectX::SimpleMath::Matrix const& transform)
+    {
+        // Patches are arrays of control points with nothing in between, so the whole shape is one run of points
+        static_assert(sizeof(shape.Patches) == sizeof(ControlPoint) * BezierTriangle<N>::NumControlPoints * M, "Patches must be tightly packed.");
+        Transform(Span<ControlPoint>(shape.Patches[0].ControlPoints, size_t(BezierTriangle<N>::NumControlPoints) * M), transform);
+    }
+
+    template<unsigned N, unsigned M>
+    void Transform(BezierShape<N, M>& shape, DirectX::SimpleMath::Quaternion const& rotation)
+    {
+        Transform(shape, DirectX::SimpleMath::Matrix::CreateFromQuaternion(rotation));
+    }
+
+    // Every patch of the store in place, FloatLanes::Width patches of one control point slot at a time
+    // The lanes past GetNumPatches stay zero, the last partial register goes through the scalar path
+    template<unsigned N>
+    void Transform(BezierPatchStore<N>& store, DirectX::SimpleMath::Matrix const& transform)
+    {
+        using namespace Simd;
+        constexpr unsigned Width = FloatLanes::Width;
+
+        TransformLanes const lanesTransform(transform);
+
+        size_t const numPatches = store.GetNumPatches();
+        size_t const numFull = numPatches / Width * Width;
+        for (unsigned slot = 0; slot < BezierPatchStore<N>::NumControlPoints; ++slot)
+        {
+            float* const xs = store.X(slot);
+            float* const ys = store.Y(slot);
+            float* const zs = store.Z(slot);
+
+            for (size_t first = 0; first < numFull; first += Width)
+            {
+                Vector3Lanes const result = lanesTransform.Apply({ Load(xs + first), Load(ys + first), Load(zs + first) });
+                Store(xs + first, result.x);
+                Store(ys + first, result.y);
+                Store(zs + first, result.z);
+            }
+
+            for (size_t patch = numFull; patch < numPatches; ++patch)
+            {
+                ControlPoint const point = TransformPoint({ xs[patch], ys[patch], zs[patch] }, transform);
+                xs[patch] = point.x;
+                ys[patch] = point.y;
+                zs[patch] = point.z;
+            }
+        }
+    }
+
+    template<unsigned N>
+    void Transform(BezierPatchStore<N>& store, DirectX::SimpleMath::Quaternion const& rotation)
+    {
+        Transform(store, DirectX::SimpleMath::Matrix::CreateFromQuaternion(rotation));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cassert>
+#include <utility>
+#include <algorithm>
+
+#include "BezierMaths.h"
+#include "BezierTessellation.h"
+
+namespace BezierMaths
+{
+    // Degrees with a compiled kernel, anything higher takes the generic path
+    static constexpr unsigned MaxSpecialisedDegree = 8;
+
+    constexpr unsigned NumTriangleControlPoints(unsigned degree)
+    {
+        return ((degree + 1) * (degree + 2)) / 2;
+    }
+
+    // Degree of a triangle with numControlPoints control points, 0 if the count isn't a triangular number
+    constexpr unsigned DegreeFromNumControlPoints(size_t numControlPoints)
+    {
+        for (unsigned degree = 1; NumTriangleControlPoints(degree) <= numControlPoints; ++degree)
+        {
+            if (NumTriangleControlPoints(degree) == numControlPoints)
+            {
+                return degree;
+            }
+        }
+
+        return 0;
+    }
+
+    // Bezier triangle whose degree is only known at runtime, control points are in the same row order as BezierTriangle<N>
+    struct BezierTriangleView
+    {
+        constexpr BezierTriangleView() = default;
+        constexpr BezierTriangleView(unsigned degree, Span<ControlPoint const> controlPoints)
+            : Degree(degree), ControlPoints(controlPoints)
+        {}
+
+        template<unsigned N>
+        constexpr BezierTriangleView(BezierTriangle<N> const& patch)
+            : Degree(N), ControlPoints(patch.ControlPoints, BezierTriangle<N>::NumControlPoints)
+        {}
+
+        // Copies the control points into a fixed degree patch, the view must be of degree N
+        template<unsigned N>
+        BezierTriangle<N> ToFixed() const
+        {
+            assert(Degree == N && ControlPoints.Size == BezierTriangle<N>::NumControlPoints);
+
+            BezierTriangle<N> result;
+            std::copy(ControlPoints.begin(), ControlPoints.end(), result.ControlPoints);
+            return result;
+        }
+
+        unsigned Degree = 0;
+        Span<ControlPoint const> ControlPoints;
+    };
+
+    // Owning counterpart for patches loaded at runtime
+    struct DynamicBezierTriangle
+    {
+        unsigned Degree = 0;
+        std::vector<ControlPoint> ControlPoints;
+
+        BezierTriangleView View() const { return { Degree, { ControlPoints.data(), ControlPoints.size() } }; }
+    };
+
+    // Kernels implement Run<N> for the specialised degrees and Generic for the rest
+    template<typename Kernel, size_t... Degrees>
+    constexpr auto MakeDegreeTable(std::index_sequence<Degrees...>)
+    {
+        return std::array{ &Kernel::template Run<unsigned(Degrees + 1)>... };
+    }
+
+    // Jumps straight to the kernel compiled for the view's degree
+    template<typename Kernel, typename... Args>
+    decltype(auto) DispatchDegree(BezierTriangleView const& patch, Args const&... args)
+    {
+        static constexpr auto table = MakeDegreeTable<Kernel>(std::make_index_sequence<MaxSpecialisedDegree>{});
+
+        assert(patch.Degree >= 1 && patch.ControlPoints.Size == NumTriangleControlPoints(patch.Degree));
+        if (patch.Degree <= MaxSpecialisedDegree)
+        {
+            return table[patch.Degree - 1](patch, args...);
+        }
+
+        return Kernel::Generic(patch, args...);
+    }
+
+    // De Casteljau down to the linear level for any degree, same in-place scheme as EvaluateLanes
+    // points is scratch space for the patch's control points, callers evaluating many points size it once and reuse it
+    inline Vertex EvaluateGeneric(BezierTriangleView const& patch, DirectX::SimpleMath::Vector3 const& uvw, ControlPoint* points)
+    {
+        std::copy(patch.ControlPoints.begin(), patch.ControlPoints.end(), points);
+        for (unsigned level = patch.Degree; level > 1; --level)
+        {
+            for (unsigned row = 0; row < level; ++row)
+            {
+                unsigned const rowStart = row * (row + 1) / 2;
+                unsigned const nextRowStart = (row + 1) * (row + 2) / 2;
+                for (unsigned k = 0; k <= row; ++k)
+                {
+                    points[rowStart + k] = points[nextRowStart + k] * uvw.x + points[rowStart + k] * uvw.y + points[nextRowStart + k + 1] * uvw.z;
+                }
+            }
+        }
+
+        ControlPoint const& p010 = points[TriangularIndex<1>::To1D(1, 0)];
+        ControlPoint const& p100 = points[TriangularIndex<1>::To1D(0, 0)];
+        ControlPoint const& p001 = points[TriangularIndex<1>::To1D(0, 1)];
+
+        auto tangent = p100 - p010;
+        auto biTangent = p001 - p010;
+        tangent.Normalize();
+        biTangent.Normalize();
+
+        auto normal = tangent.Cross(biTangent);
+        normal.Normalize();
+        return { { p100 * uvw.x + p010 * uvw.y + p001 * uvw.z }, normal };
+    }
+
+    inline Vertex EvaluateGeneric(BezierTriangleView const& patch, DirectX::SimpleMath::Vector3 const& uvw)
+    {
+        std::vector<ControlPoint> points(patch.ControlPoints.Size);
+        return EvaluateGeneric(patch, uvw, points.data());
+    }
+
+    struct EvaluateKernel
+    {
+        template<unsigned N>
+        static Vertex Run(BezierTriangleView const& patch, DirectX::SimpleMath::Vector3 const& uvw)
+        {
+            return BezierMaths::Evaluate(patch.ToFixed<N>(), uvw);
+        }
+
+        static Vertex Generic(BezierTriangleView const& patch, DirectX::SimpleMath::Vector3 const& uvw)
+        {
+            return EvaluateGeneric(patch, uvw);
+        }
+    };
+
+    struct TessellateIndexedKernel
+    {
+        template<unsigned N>
+        static IndexedMesh<uint32_t> Run(BezierTriangleView const& patch, TessellationOptions const& options)
+        {
+            return TessellatePatchIndexed<N, uint32_t>(patch.ToFixed<N>(), options);
+        }
+
+        static IndexedMesh<uint32_t> Generic(BezierTriangleView const& patch, TessellationOptions const& options)
+        {
+            unsigned const numRows = options.NumRows;
+            CheckIndexRange<uint32_t>(numRows);
+
+            // One scratch copy of the control points for the whole grid
+            std::vector<ControlPoint> points(patch.ControlPoints.Size);
+
+            IndexedMesh<uint32_t> result;
+            result.Vertices.reserve(NumGridVertices(numRows));
+            for (unsigned row = 0; row <= numRows; ++row)
+            {
+                for (unsigned column = 0; column <= row; ++column)
+                {
+                    result.Vertices.push_back(EvaluateGeneric(patch, GridVertexUVW(numRows, row, column), points.data()));
+                }
+            }
+
+            result.Indices.resize(numRows * numRows * 3);
+            WriteGridIndices<uint32_t>(numRows, 0, result.Indices.data());
+            return result;
+        }
+    };
+
+    struct TessellateKernel
+    {
+        template<unsigned N>
+        static std::vector<Triangle> Run(BezierTriangleView const& patch, TessellationOptions const& options)
+        {
+            return TessellatePatch(patch.ToFixed<N>(), options);
+        }
+
+        static std::vector<Triangle> Generic(BezierTriangleView const& patch, TessellationOptions const& options)
+        {
+            auto const mesh = TessellateIndexedKernel::Generic(patch, options);
+
+            std::vector<Triangle> result(mesh.Indices.size() / 3);
+            for (size_t i = 0; i < result.size(); ++i)
+            {
+                result[i] = { mesh.Vertices[mesh.Indices[i * 3]], mesh.Vertices[mesh.Indices[i * 3 + 1]], mesh.Vertices[mesh.Indices[i * 3 + 2]] };
+            }
+
+            return result;
+        }
+    };
+
+    inline Vertex Evaluate(BezierTriangleView const& patch, DirectX::SimpleMath::Vector3 const& uvw)
+    {
+        return DispatchDegree<EvaluateKernel>(patch, uvw);
+    }
+
+    inline std::vector<Triangle> TessellatePatch(BezierTriangleView const& patch, TessellationOptions const& options = {})
+    {
+        return DispatchDegree<TessellateKernel>(patch, options);
+    }
+
+    inline IndexedMesh<uint32_t> TessellatePatchIndexed(BezierTriangleView const& patch, TessellationOptions const& options = {})
+    {
+        return DispatchDegree<TessellateIndexedKernel>(patch, options);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "stdafx.h"
+#include "ThreadPool.h"
+
+namespace
+{
+    // Lets a worker find its own queue, tasks from a different pool fall back to the shared queue
+    thread_local ThreadPool const* t_pool = nullptr;
+    thread_local unsigned t_queueIndex = 0;
+}
+
+ThreadPool::ThreadPool(unsigned numThreads)
+{
+    for (unsigned i = 0; i <= numThreads; ++i)
+    {
+        m_queues.push_back(std::make_unique<WorkQueue>());
+    }
+
+    m_threads.reserve(numThreads);
+    for (unsigned i = 0; i < numThreads; ++i)
+    {
+        m_threads.emplace_back([this, i]() { WorkerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stop = true;
+    }
+
+    m_wakeCondition.notify_all();
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+ThreadPool& ThreadPool::GetDefault()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+unsigned ThreadPool::GetCurrentQueueIndex() const
+{
+    return t_pool == this ? t_queueIndex : static_cast<unsigned>(m_threads.size());
+}
+
+void ThreadPool::Submit(std::function<void()> task)
+{
+    {
+        WorkQueue& queue = *m_queues[GetCurrentQueueIndex()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+
+    {
+        // Bump the count under the wake mutex so a worker can't miss it between checking and waiting
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_numQueuedTasks.fetch_add(1, std::memory_order_release);
+    }
+
+    m_wakeCondition.notify_one();
+}
+
+bool ThreadPool::TryPopBack(WorkQueue& queue, std::function<void()>& task)
+{
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty())
+    {
+        return false;
+    }
+
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::TryPopFront(WorkQueue& queue, std::function<void()>& task)
+{
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty())
+    {
+        return false;
+    }
+
+    task = std::move(queue.tasks.front());
+    queue.tasks.pop_front();
+    return true;
+}
+
+bool ThreadPool::TryGetTask(std::function<void()>& task)
+{
+    unsigned const self = GetCurrentQueueIndex();
+    unsigned const numQueues = static_cast<unsigned>(m_queues.size());
+
+    // Newest work of our own first since its data is still in cache
+    bool found = TryPopBack(*m_queues[self], task);
+
+    // Then steal the oldest, and so largest, work from everyone else starting with our neighbour
+    for (unsigned offset = 1; !found && offset < numQueues; ++offset)
+    {
+        found = TryPopFront(*m_queues[(self + offset) % numQueues], task);
+    }
+
+    if (found)
+    {
+        m_numQueuedTasks.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    return found;
+}
+
+bool ThreadPool::RunPendingTask()
+{
+    std::function<void()> task;
+    if (!TryGetTask(task))
+    {
+        return false;
+    }
+
+    task();
+    return true;
+}
+
+void ThreadPool::WorkerLoop(unsigned index)
+{
+    t_pool = this;
+    t_queueIndex = index;
+
+    while (true)
+    {
+        if (RunPendingTask())
+        {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wakeCondition.wait(lock, [this]() { return m_stop || m_numQueuedTasks.load(std::memory_order_acquire) > 0; });
+
+        if (m_stop)
+        {
+            return;
+        }
+    }
+}
\ No newline at end of file
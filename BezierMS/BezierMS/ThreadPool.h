@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+// Work stealing thread pool
+// Every worker owns a deque, it pushes and pops its own tasks at the back and steals from the front of the others when it runs dry
+// Threads that are not workers push to a shared queue which every worker steals from
+class ThreadPool
+{
+public:
+    explicit ThreadPool(unsigned numThreads = (std::max)(1u, std::thread::hardware_concurrency()));
+    ~ThreadPool();
+
+    ThreadPool(ThreadPool const&) = delete;
+    ThreadPool& operator=(ThreadPool const&) = delete;
+
+    unsigned GetNumThreads() const { return static_cast<unsigned>(m_threads.size()); }
+
+    void Submit(std::function<void()> task);
+
+    // Runs one queued task on the calling thread, returns false if there was nothing to run
+    bool RunPendingTask();
+
+    // Calls body(begin, end) over sub-ranges of [0, count) no larger than grainSize and blocks until all of them are done
+    // Ranges are split in halves, one half is queued for stealing and the other is kept, so idle workers take the biggest pieces
+    // The calling thread runs tasks while it waits, so this may be called from inside a task
+    // The first exception thrown by body is rethrown here once every range has finished
+    template<typename Function>
+    void ParallelFor(size_t count, size_t grainSize, Function const& body);
+
+    // Process wide pool with one worker per hardware thread
+    static ThreadPool& GetDefault();
+
+private:
+    struct WorkQueue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void WorkerLoop(unsigned index);
+    bool TryPopBack(WorkQueue& queue, std::function<void()>& task);
+    bool TryPopFront(WorkQueue& queue, std::function<void()>& task);
+    bool TryGetTask(std::function<void()>& task);
+    unsigned GetCurrentQueueIndex() const;
+
+    // One queue per worker followed by the shared queue
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+    std::atomic<size_t> m_numQueuedTasks = 0;
+    bool m_stop = false;
+};
+
+template<typename Function>
+void ThreadPool::ParallelFor(size_t count, size_t grainSize, Function const& body)
+{
+    grainSize = std::max<size_t>(grainSize, 1);
+    if (count <= grainSize || m_threads.empty())
+    {
+        if (count > 0)
+        {
+            body(size_t(0), count);
+        }
+
+        return;
+    }
+
+    std::atomic<size_t> remaining = count;
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    std::function<void(size_t, size_t)> run = [&](size_t begin, size_t end)
+    {
+        while (end - begin > grainSize)
+        {
+            size_t const middle = begin + (end - begin) / 2;
+            Submit([&run, middle, end]() { run(middle, end); });
+            end = middle;
+        }
+
+        try
+        {
+            body(begin, end);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error)
+            {
+                error = std::current_exception();
+            }
+        }
+
+        remaining.fetch_sub(end - begin, std::memory_order_acq_rel);
+    };
+
+    run(0, count);
+
+    while (remaining.load(std::memory_order_acquire) != 0)
+    {
+        if (!RunPendingTask())
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include <cmath>
+#include <map>
+#include <random>
+#include <utility>
+#include <algorithm>
+
+#include "BezierAdaptive.h"
+#include "Tests.h"
+
+using namespace BezierMaths;
+using DirectX::SimpleMath::Vector3;
+
+namespace
+{
+    // Height field patch over the unit triangle in x and z with random bumps in y, so the domain point of a vertex is its x and z
+    template<unsigned N>
+    BezierTriangle<N> MakeBumpyPatch(float amplitude, std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> height(-amplitude, amplitude);
+
+        BezierTriangle<N> patch;
+        for (unsigned j = 0; j <= N; ++j)
+        {
+            for (unsigned k = 0; j + k <= N; ++k)
+            {
+                patch.ControlPoints[TriangularIndex<N>::To1D(j, k)] = { float(N - j - k) / N, height(rng), float(k) / N };
+            }
+        }
+
+        return patch;
+    }
+
+    // Every edge is shared by two triangles unless it lies on the patch boundary, an edge used once inside the patch is a T-junction
+    bool IsWatertight(IndexedMesh<uint32_t> const& mesh)
+    {
+        std::map<std::pair<uint32_t, uint32_t>, unsigned> edgeUses;
+        for (size_t index = 0; index < mesh.Indices.size(); index += 3)
+        {
+            for (unsigned edge = 0; edge < 3; ++edge)
+            {
+                uint32_t const a = mesh.Indices[index + edge], b = mesh.Indices[index + (edge + 1) % 3];
+                ++edgeUses[{ (std::min)(a, b), (std::max)(a, b) }];
+            }
+        }
+
+        auto const onBoundary = [&mesh](uint32_t vertex)
+        {
+            Vector3 const& position = mesh.Vertices[vertex].position;
+            return position.x <= 1e-6f || position.z <= 1e-6f || std::abs(position.x + position.z - 1.f) <= 1e-5f;
+        };
+
+        for (auto const& edge : edgeUses)
+        {
+            bool const boundary = onBoundary(edge.first.first) && onBoundary(edge.first.second);
+            if (edge.second > 2 || (edge.second == 1 && !boundary))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+void RunAdaptiveTests(TestContext& context)
+{
+    std::mt19937 rng(6);
+
+    // Low depth limits cut the recursion short on bumpy patches, the default one lets the tolerance decide
+    for (unsigned maxDepth : { 0u, 1u, 2u, 3u, 5u, 8u, 32u })
+    {
+        for (unsigned run = 0; run < 4; ++run)
+        {
+            AdaptiveTessellationOptions options;
+            options.MaxDepth = maxDepth;
+
+            options.Tolerance = 1e-3f;
+            context.Check(IsWatertight(TessellatePatchAdaptive(MakeBumpyPatch<3>(0.5f, rng), options)), "a cubic adaptive mesh has no T-junctions at any depth limit");
+
+            options.Tolerance = 1e-2f;
+            context.Check(IsWatertight(TessellatePatchAdaptive(MakeBumpyPatch<5>(0.5f, rng), options)), "a quintic adaptive mesh has no T-junctions at any depth limit");
+        }
+    }
+}
\ No newline at end of file
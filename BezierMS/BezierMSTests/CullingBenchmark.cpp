@@ -0,0 +1,75 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+
+#include "BezierCulling.h"
+#include "Tests.h"
+#include "TestPatches.h"
+
+using namespace BezierMaths;
+using DirectX::SimpleMath::Vector3;
+
+namespace
+{
+    constexpr unsigned Degree = 3;
+
+    // Best of a few runs in nanoseconds per patch, the first run also warms the caches
+    template<typename Function>
+    double TimePerPatch(size_t numPatches, Function&& function)
+    {
+        constexpr unsigned NumRuns = 5;
+
+        double best = 0.;
+        for (unsigned run = 0; run < NumRuns; ++run)
+        {
+            auto const start = std::chrono::steady_clock::now();
+            function();
+            double const elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            best = run == 0 ? elapsed : (std::min)(best, elapsed);
+        }
+
+        return best / double(numPatches);
+    }
+}
+
+void RunCullingBenchmark()
+{
+    std::mt19937 rng(4);
+
+    std::printf("%10s %14s %14s %14s %10s\n", "patches", "cones ns", "bounds ns", "cull ns", "kept");
+    for (size_t numPatches : { size_t(1) << 10, size_t(1) << 14, size_t(1) << 18 })
+    {
+        // Patches all over the unit sphere seen from outside, so about half of them face away
+        BezierPatchStore<Degree> store(numPatches);
+        for (size_t patch = 0; patch < numPatches; ++patch)
+        {
+            store.Add(TestPatches::MakeRandomSpherePatch<Degree>(0.05f, 0.f, rng));
+        }
+
+        std::vector<NormalCone> cones(numPatches);
+        double const conesTime = TimePerPatch(numPatches, [&] { ComputeNormalCones(store, Span<NormalCone>(cones.data(), numPatches)); });
+
+        std::vector<PatchBounds> bounds(numPatches);
+        double const boundsTime = TimePerPatch(numPatches, [&]
+        {
+            for (size_t first = 0; first < numPatches; first += Simd::FloatLanes::Width)
+            {
+                ComputeBounds(store, first, &bounds[first]);
+            }
+        });
+
+        Vector3 const eye(0.f, 0.f, -5.f);
+        std::vector<uint32_t> indices;
+        double const cullTime = TimePerPatch(numPatches, [&]
+        {
+            indices.resize(numPatches);
+            std::iota(indices.begin(), indices.end(), 0u);
+            CullBackFacing({ cones.data(), numPatches }, { bounds.data(), numPatches }, eye, indices);
+        });
+
+        std::printf("%10zu %14.1f %14.1f %14.1f %9.1f%%\n", numPatches, conesTime, boundsTime, cullTime, 100. * double(indices.size()) / double(numPatches));
+    }
+}
\ No newline at end of file
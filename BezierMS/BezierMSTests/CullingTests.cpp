@@ -0,0 +1,285 @@
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+
+#include "BezierCulling.h"
+#include "Tests.h"
+#include "TestPatches.h"
+
+using namespace BezierMaths;
+using DirectX::SimpleMath::Matrix;
+using DirectX::SimpleMath::Vector3;
+
+namespace
+{
+    constexpr unsigned Degree = 3;
+
+    // Evaluate normals can be off by a few float roundings from the exact surface normal the cone bounds
+    constexpr float ConeTolerance = 1e-4f;
+
+    // Samples a grid of barycentric coordinates on the patch, corners included, and checks each Evaluate normal is inside the cone
+    template<unsigned N>
+    bool ConeHoldsNormals(BezierTriangle<N> const& patch, NormalCone const& cone)
+    {
+        if (cone.CosHalfAngle <= 0.f)
+        {
+            return true;
+        }
+
+        constexpr unsigned NumSteps = 12;
+        for (unsigned j = 0; j <= NumSteps; ++j)
+        {
+            for (unsigned k = 0; j + k <= NumSteps; ++k)
+            {
+                Vector3 const uvw(float(NumSteps - j - k) / NumSteps, float(j) / NumSteps, float(k) / NumSteps);
+                Vector3 const normal = Evaluate(patch, uvw).normal;
+                if (normal.LengthSquared() > 0.5f && normal.Dot(cone.Axis) < cone.CosHalfAngle - ConeTolerance)
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    void TestConesHoldSampledNormals(TestContext& context)
+    {
+        std::mt19937 rng(1);
+
+        // Octants of the unit sphere like the shipped scene, each winding
+        Vector3 const axes[3] = { { 1.f, 0.f, 0.f }, { 0.f, 1.f, 0.f }, { 0.f, 0.f, 1.f } };
+        for (float sx : { -1.f, 1.f })
+        {
+            for (float sy : { -1.f, 1.f })
+            {
+                for (float sz : { -1.f, 1.f })
+                {
+                    auto const octant = TestPatches::MakeSpherePatch<Degree>(axes[0] * sx, axes[1] * sy, axes[2] * sz, 0.f, rng);
+                    NormalCone const cone = ComputeNormalCone(octant);
+                    context.Check(cone.CosHalfAngle > 0.f, "an octant patch gets a cone narrower than a half space");
+                    context.Check(ConeHoldsNormals(octant, cone), "the cone of an octant patch holds its sampled normals");
+                }
+            }
+        }
+
+        // Small and large random patches with and without bumps
+        for (unsigned patch = 0; patch < 500; ++patch)
+        {
+            float const spread = patch % 2 ? 0.1f : 0.6f;
+            float const noise = patch % 3 == 0 ? 0.f : 0.02f;
+            auto const random = TestPatches::MakeRandomSpherePatch<Degree>(spread, noise, rng);
+            context.Check(ConeHoldsNormals(random, ComputeNormalCone(random)), "the cone of a random patch holds its sampled normals");
+        }
+    }
+
+    void TestStoreConesMatchSinglePatch(TestContext& context)
+    {
+        std::mt19937 rng(2);
+
+        // Counts around the register width so the last register is empty, partial and full
+        constexpr unsigned Width = Simd::FloatLanes::Width;
+        for (size_t numPatches : { size_t(1), size_t(Width - 1), size_t(Width), size_t(Width + 1), size_t(3 * Width + Width / 2 + 1) })
+        {
+            BezierPatchStore<Degree> store;
+            std::vector<BezierTriangle<Degree>> patches;
+            for (size_t patch = 0; patch < numPatches; ++patch)
+            {
+                patches.push_back(TestPatches::MakeRandomSpherePatch<Degree>(0.3f, 0.01f, rng));
+                store.Add(patches.back());
+            }
+
+            // One past the end catches writes for lanes that don't hold a patch
+            std::vector<NormalCone> cones(numPatches + 1);
+            cones.back().CosHalfAngle = 2.f;
+            ComputeNormalCones(store, Span<NormalCone>(cones.data(), numPatches));
+            context.Check(cones.back().CosHalfAngle == 2.f, "ComputeNormalCones writes only one cone per patch");
+
+            for (size_t patch = 0; patch < numPatches; ++patch)
+            {
+                NormalCone const single = ComputeNormalCone(patches[patch]);
+                bool const same = (cones[patch].Axis - single.Axis).Length() <= 1e-6f
+                    && std::abs(cones[patch].CosHalfAngle - single.CosHalfAngle) <= 1e-6f
+                    && std::abs(cones[patch].SinHalfAngle - single.SinHalfAngle) <= 1e-6f;
+                context.Check(same, "store cones match the single patch cones, including the last partial register");
+            }
+        }
+    }
+
+    void TestCullBackFacing(TestContext& context)
+    {
+        std::mt19937 rng(3);
+
+        auto const octant = TestPatches::MakeSpherePatch<Degree>({ 1.f, 0.f, 0.f }, { 0.f, 1.f, 0.f }, { 0.f, 0.f, 1.f }, 0.f, rng);
+        NormalCone const cone = ComputeNormalCone(octant);
+        PatchBounds const bounds = ComputeBounds(octant);
+
+        // Direction the patch faces in the middle and one along the surface there
+        Vector3 const normal = Evaluate(octant, Vector3(1.f / 3.f, 1.f / 3.f, 1.f / 3.f)).normal;
+        Vector3 tangent = normal.Cross(Vector3(1.f, -1.f, 0.f));
+        tangent.Normalize();
+
+        NormalCone const cones[] = { cone };
+        PatchBounds const boundsList[] = { bounds };
+        auto const isKept = [&](Vector3 const& eye)
+        {
+            uint32_t indices[] = { 0 };
+            return CullBackFacing({ cones, 1 }, { boundsList, 1 }, eye, indices, 1) == 1;
+        };
+
+        Vector3 const behind = bounds.Center - normal * 100.f;
+        Vector3 const inFront = bounds.Center + normal * 100.f;
+        Vector3 const silhouette = bounds.Center + tangent * 100.f;
+
+        context.Check(!isKept(behind), "CullBackFacing rejects a patch facing away from the eye");
+        context.Check(IsBackFacing(cone, bounds, behind), "IsBackFacing agrees for a patch facing away from the eye");
+        context.Check(isKept(inFront), "CullBackFacing keeps a patch facing the eye");
+        context.Check(isKept(silhouette), "CullBackFacing keeps a silhouette patch");
+        context.Check(!IsBackFacing(cone, bounds, silhouette), "IsBackFacing agrees for a silhouette patch");
+        context.Check(isKept(bounds.Center), "CullBackFacing keeps a patch whose bounds hold the eye");
+
+        // Mixed list with a partial register, only the patches facing away go and the order of the rest is kept
+        constexpr unsigned Width = Simd::FloatLanes::Width;
+        size_t const numPatches = 2 * Width + 3;
+        std::vector<NormalCone> manyCones(numPatches, cone);
+        std::vector<PatchBounds> manyBounds(numPatches, bounds);
+        for (size_t patch = 0; patch < numPatches; patch += 3)
+        {
+            // Flip every third patch to face the other way
+            manyCones[patch].Axis = -cone.Axis;
+        }
+
+        std::vector<uint32_t> indices(numPatches);
+        std::iota(indices.begin(), indices.end(), 0u);
+        CullBackFacing({ manyCones.data(), numPatches }, { manyBounds.data(), numPatches }, inFront, indices);
+
+        std::vector<uint32_t> expected;
+        for (uint32_t patch = 0; patch < numPatches; ++patch)
+        {
+            if (patch % 3 != 0)
+            {
+                expected.push_back(patch);
+            }
+        }
+
+        context.Check(indices == expected, "CullBackFacing drops only the flipped patches and keeps the order");
+    }
+
+    // True if side of frustum has the given inward normal and distance
+    // The far plane subtracts two nearly equal columns, so distances are compared relative to their size
+    bool PlaneMatches(Frustum const& frustum, Frustum::Side side, Vector3 const& normal, float distance)
+    {
+        return (frustum.Normals[side] - normal).Length() <= 1e-5f && std::abs(frustum.Distances[side] - distance) <= 1e-5f * (std::max)(1.f, std::abs(distance));
+    }
+
+    void TestFrustumPlanes(TestContext& context)
+    {
+        // Camera space looks down -z, so an off centre box from x -2 to 4, y -1 to 3 and depth 1 to 11 has axis aligned planes
+        Frustum const box = Frustum::FromViewProjection(Matrix::CreateOrthographicOffCenter(-2.f, 4.f, -1.f, 3.f, 1.f, 11.f));
+        context.Check(PlaneMatches(box, Frustum::Left, { 1.f, 0.f, 0.f }, 2.f), "orthographic left plane is x = -2");
+        context.Check(PlaneMatches(box, Frustum::Right, { -1.f, 0.f, 0.f }, 4.f), "orthographic right plane is x = 4");
+        context.Check(PlaneMatches(box, Frustum::Bottom, { 0.f, 1.f, 0.f }, 1.f), "orthographic bottom plane is y = -1");
+        context.Check(PlaneMatches(box, Frustum::Top, { 0.f, -1.f, 0.f }, 3.f), "orthographic top plane is y = 3");
+        context.Check(PlaneMatches(box, Frustum::Near, { 0.f, 0.f, -1.f }, -1.f), "orthographic near plane is z = -1");
+        context.Check(PlaneMatches(box, Frustum::Far, { 0.f, 0.f, 1.f }, 11.f), "orthographic far plane is z = -11");
+
+        // A 90 degree square perspective from an eye at z = 5 has side planes at 45 degrees through the eye
+        float const diagonal = std::sqrt(0.5f);
+        Matrix const view = Matrix::CreateTranslation(0.f, 0.f, -5.f);
+        Frustum const perspective = Frustum::FromViewProjection(view * Matrix::CreatePerspectiveFieldOfView(DirectX::XM_PIDIV2, 1.f, 1.f, 100.f));
+        context.Check(PlaneMatches(perspective, Frustum::Left, { diagonal, 0.f, -diagonal }, 5.f * diagonal), "perspective left plane goes through the eye at 45 degrees");
+        context.Check(PlaneMatches(perspective, Frustum::Right, { -diagonal, 0.f, -diagonal }, 5.f * diagonal), "perspective right plane goes through the eye at 45 degrees");
+        context.Check(PlaneMatches(perspective, Frustum::Bottom, { 0.f, diagonal, -diagonal }, 5.f * diagonal), "perspective bottom plane goes through the eye at 45 degrees");
+        context.Check(PlaneMatches(perspective, Frustum::Top, { 0.f, -diagonal, -diagonal }, 5.f * diagonal), "perspective top plane goes through the eye at 45 degrees");
+        context.Check(PlaneMatches(perspective, Frustum::Near, { 0.f, 0.f, -1.f }, 4.f), "perspective near plane is one unit in front of the eye");
+        context.Check(PlaneMatches(perspective, Frustum::Far, { 0.f, 0.f, 1.f }, 95.f), "perspective far plane is a hundred units in front of the eye");
+    }
+
+    // Boxes inside, outside and straddling the orthographic frustum of TestFrustumPlanes, outside and straddling go round its six sides
+    enum class Placement { Inside, Outside, Straddling };
+
+    PatchBounds MakeBox(Placement placement, size_t index)
+    {
+        // Middle of the frustum and a point past each side, the straddling boxes reach from the middle to past a side
+        Vector3 const centre(1.f, 1.f, -6.f);
+        Vector3 const pastSide[Frustum::NumSides] = { { -3.f, 1.f, -6.f }, { 5.f, 1.f, -6.f }, { 1.f, -2.f, -6.f }, { 1.f, 4.f, -6.f }, { 1.f, 1.f, -0.5f }, { 1.f, 1.f, -12.f } };
+        Vector3 const halfSize(0.25f, 0.25f, 0.25f);
+        Vector3 const& side = pastSide[index % Frustum::NumSides];
+
+        PatchBounds bounds;
+        switch (placement)
+        {
+        case Placement::Inside:
+            bounds.Min = centre - halfSize;
+            bounds.Max = centre + halfSize;
+            break;
+        case Placement::Outside:
+            bounds.Min = side - halfSize;
+            bounds.Max = side + halfSize;
+            break;
+        case Placement::Straddling:
+            bounds.Min = Vector3::Min(centre, side) - halfSize;
+            bounds.Max = Vector3::Max(centre, side) + halfSize;
+            break;
+        }
+
+        bounds.Center = (bounds.Min + bounds.Max) * 0.5f;
+        bounds.Radius = (bounds.Max - bounds.Center).Length();
+        return bounds;
+    }
+
+    void TestCullPatches(TestContext& context)
+    {
+        Frustum const frustum = Frustum::FromViewProjection(Matrix::CreateOrthographicOffCenter(-2.f, 4.f, -1.f, 3.f, 1.f, 11.f));
+
+        context.Check(Intersects(frustum, MakeBox(Placement::Inside, 0)) == Containment::Inside, "Intersects finds the inside box inside");
+        for (size_t side = 0; side < Frustum::NumSides; ++side)
+        {
+            context.Check(Intersects(frustum, MakeBox(Placement::Outside, side)) == Containment::Outside, "Intersects finds a box past a side outside");
+            context.Check(Intersects(frustum, MakeBox(Placement::Straddling, side)) == Containment::Intersects, "Intersects finds a box across a side intersecting");
+        }
+
+        // Counts around the register width so the last register is partial, full and just started
+        constexpr unsigned Width = Simd::FloatLanes::Width;
+        for (size_t numPatches : { size_t(0), size_t(1), size_t(Width - 1), size_t(Width), size_t(Width + 1), size_t(2 * Width + 3) })
+        {
+            Placement const pattern[] = { Placement::Inside, Placement::Outside, Placement::Straddling, Placement::Outside, Placement::Inside };
+
+            std::vector<PatchBounds> bounds;
+            std::vector<uint32_t> expected;
+            for (size_t patch = 0; patch < numPatches; ++patch)
+            {
+                Placement const placement = pattern[patch % 5];
+                bounds.push_back(MakeBox(placement, patch));
+                if (placement != Placement::Outside)
+                {
+                    expected.push_back(uint32_t(patch));
+                }
+            }
+
+            // One past the end catches writes for lanes that don't hold a patch
+            std::vector<uint32_t> visible(numPatches + 1, ~0u);
+            size_t const numVisible = CullPatches(frustum, { bounds.data(), numPatches }, visible.data());
+            context.Check(visible.back() == ~0u, "CullPatches writes no more indices than there are patches");
+
+            visible.resize(numVisible);
+            context.Check(visible == expected, "CullPatches keeps the inside and straddling patches in order");
+
+            std::vector<uint32_t> visibleVector;
+            CullPatches(frustum, { bounds.data(), numPatches }, visibleVector);
+            context.Check(visibleVector == expected, "the vector CullPatches overload gives the same list");
+        }
+    }
+}
+
+void RunCullingTests(TestContext& context)
+{
+    TestConesHoldSampledNormals(context);
+    TestStoreConesMatchSinglePatch(context);
+    TestCullBackFacing(context);
+    TestFrustumPlanes(context);
+    TestCullPatches(context);
+}
\ No newline at end of file
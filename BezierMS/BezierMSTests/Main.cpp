@@ -0,0 +1,25 @@
+#include <cstdio>
+#include <cstring>
+
+#include "Tests.h"
+
+// Runs every test and returns non-zero if any check failed, --benchmark also times the culling passes
+int main(int argc, char** argv)
+{
+    TestContext context;
+    RunPatchStoreTests(context);
+    RunQuantisationTests(context);
+    RunCullingTests(context);
+    RunAdaptiveTests(context);
+    std::printf("%zu checks, %zu failed\n", context.Checks, context.Failures);
+
+    for (int arg = 1; arg < argc; ++arg)
+    {
+        if (std::strcmp(argv[arg], "--benchmark") == 0)
+        {
+            RunCullingBenchmark();
+        }
+    }
+
+    return context.Failures == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include <random>
+
+#include "BezierPatchStore.h"
+#include "BezierTransform.h"
+#include "Tests.h"
+#include "TestPatches.h"
+
+using namespace BezierMaths;
+
+namespace
+{
+    constexpr unsigned Degree = 3;
+
+    // Everything that walks the component arrays has to cope with a store that never allocated any
+    void TestEmptyStore(TestContext& context)
+    {
+        BezierPatchStore<Degree> store;
+        BezierPatchStore<Degree> const& constStore = store;
+
+        context.Check(constStore.X(0) == nullptr && constStore.Z(BezierPatchStore<Degree>::NumControlPoints - 1) == nullptr,
+                      "an empty store hands out null component arrays");
+        context.Check(constStore.GetPackedControlPoints().Empty(), "an empty store packs no control points");
+
+        Transform(store, DirectX::SimpleMath::Matrix::CreateTranslation(1.f, 2.f, 3.f));
+        context.Check(store.GetNumPatches() == 0 && store.GetCapacity() == 0, "transforming an empty store leaves it empty");
+
+        store.Resize(0);
+        context.Check(store.GetNumPatches() == 0 && store.GetCapacity() == 0, "resizing an empty store to zero allocates nothing");
+
+        store.Clear();
+        context.Check(store.GetNumPatches() == 0, "clearing an empty store leaves it empty");
+    }
+
+    void TestResize(TestContext& context)
+    {
+        std::mt19937 rng(5);
+
+        // Fill the store to its capacity so shrinking clears right up to the end of the last component array
+        BezierPatchStore<Degree> store(BezierPatchStore<Degree>::PatchGranularity);
+        while (store.GetNumPatches() < store.GetCapacity())
+        {
+            store.Add(TestPatches::MakeRandomSpherePatch<Degree>(0.3f, 0.f, rng));
+        }
+
+        BezierTriangle<Degree> const first = store.Get(0);
+        store.Resize(1);
+
+        BezierPatchStore<Degree> const& constStore = store;
+        bool paddingZero = true;
+        for (unsigned slot = 0; slot < BezierPatchStore<Degree>::NumControlPoints; ++slot)
+        {
+            for (size_t patch = 1; patch < constStore.GetCapacity(); ++patch)
+            {
+                paddingZero = paddingZero && constStore.X(slot)[patch] == 0.f && constStore.Y(slot)[patch] == 0.f && constStore.Z(slot)[patch] == 0.f;
+            }
+        }
+
+        context.Check(paddingZero, "shrinking a full store zeroes every dropped lane");
+
+        bool kept = true;
+        for (unsigned slot = 0; slot < BezierPatchStore<Degree>::NumControlPoints; ++slot)
+        {
+            kept = kept && store.Get(0).ControlPoints[slot] == first.ControlPoints[slot];
+        }
+
+        context.Check(kept, "shrinking keeps the patches below the new size");
+
+        store.Resize(0);
+        context.Check(store.GetNumPatches() == 0 && store.GetPackedControlPoints().Empty(), "resizing to zero drops every patch");
+    }
+}
+
+void RunPatchStoreTests(TestContext& context)
+{
+    TestEmptyStore(context);
+    TestResize(context);
+}
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include <cmath>
+#include <random>
+#include <string>
+
+#include "BezierQuantisation.h"
+#include "Tests.h"
+#include "TestPatches.h"
+
+using namespace BezierMaths;
+
+namespace
+{
+    constexpr unsigned Degree = 3;
+
+    // Largest difference on any axis between two stores over the first numPatches patches
+    float MaxDifference(BezierPatchStore<Degree> const& a, BezierPatchStore<Degree> const& b, size_t numPatches)
+    {
+        float difference = 0.f;
+        for (unsigned slot = 0; slot < BezierPatchStore<Degree>::NumControlPoints; ++slot)
+        {
+            for (size_t patch = 0; patch < numPatches; ++patch)
+            {
+                difference = (std::max)({ difference, std::abs(a.X(slot)[patch] - b.X(slot)[patch]), std::abs(a.Y(slot)[patch] - b.Y(slot)[patch]),
+                                          std::abs(a.Z(slot)[patch] - b.Z(slot)[patch]) });
+            }
+        }
+
+        return difference;
+    }
+
+    // Round trips patches scattered over a large box, so per patch boxes are much tighter than the shape's
+    void TestRoundTrip(TestContext& context, size_t numPatches, QuantisationBounds bounds)
+    {
+        std::mt19937 rng(unsigned(numPatches) + 7);
+        std::uniform_real_distribution<float> position(-50.f, 50.f);
+
+        BezierPatchStore<Degree> store;
+        for (size_t patch = 0; patch < numPatches; ++patch)
+        {
+            BezierTriangle<Degree> triangle = TestPatches::MakeRandomSpherePatch<Degree>(0.3f, 0.01f, rng);
+            DirectX::SimpleMath::Vector3 const offset(position(rng), position(rng), position(rng));
+            for (auto& controlPoint : triangle.ControlPoints)
+            {
+                controlPoint += offset;
+            }
+
+            store.Add(triangle);
+        }
+
+        auto const quantised = QuantisedPatches<Degree>::Encode(store, bounds);
+
+        // Decode into a store that already holds more, larger patches so shrinking and overwriting are both exercised
+        BezierPatchStore<Degree> decoded;
+        for (size_t patch = 0; patch < numPatches + Simd::FloatLanes::Width + 1; ++patch)
+        {
+            decoded.Add(TestPatches::MakeRandomSpherePatch<Degree>(0.3f, 0.f, rng));
+        }
+
+        quantised.Decode(decoded);
+
+        std::string const name = std::to_string(numPatches) + (bounds == QuantisationBounds::PerShape ? " patches per shape" : " patches per patch");
+        context.Check(decoded.GetNumPatches() == numPatches, (name + ": decoding gives back every patch").c_str());
+        context.Check(MaxDifference(store, decoded, numPatches) <= quantised.GetErrorBound(), (name + ": every coordinate is within the error bound").c_str());
+
+        bool paddingZero = true;
+        BezierPatchStore<Degree> const& constDecoded = decoded;
+        for (unsigned slot = 0; slot < BezierPatchStore<Degree>::NumControlPoints; ++slot)
+        {
+            for (size_t patch = numPatches; patch < constDecoded.GetCapacity(); ++patch)
+            {
+                paddingZero = paddingZero && constDecoded.X(slot)[patch] == 0.f && constDecoded.Y(slot)[patch] == 0.f && constDecoded.Z(slot)[patch] == 0.f;
+            }
+        }
+
+        context.Check(paddingZero, (name + ": lanes past the decoded patches are zero").c_str());
+
+        bool patchesMatch = true;
+        for (size_t patch = 0; patch < numPatches; ++patch)
+        {
+            BezierTriangle<Degree> const single = quantised.DecodePatch(patch);
+            BezierTriangle<Degree> const whole = decoded.Get(patch);
+            for (unsigned slot = 0; slot < BezierPatchStore<Degree>::NumControlPoints; ++slot)
+            {
+                patchesMatch = patchesMatch && (single.ControlPoints[slot] - whole.ControlPoints[slot]).Length() <= quantised.GetErrorBound();
+            }
+        }
+
+        context.Check(patchesMatch, (name + ": DecodePatch matches Decode").c_str());
+    }
+
+    // Patches that are a single point have zero extent boxes and have to come back exactly
+    void TestFlatPatches(TestContext& context)
+    {
+        BezierTriangle<Degree> point;
+        for (auto& controlPoint : point.ControlPoints)
+        {
+            controlPoint = { 1.5f, -2.f, 3.25f };
+        }
+
+        BezierPatchStore<Degree> store;
+        store.Add(point);
+        store.Add(point);
+
+        for (QuantisationBounds bounds : { QuantisationBounds::PerShape, QuantisationBounds::PerPatch })
+        {
+            BezierPatchStore<Degree> decoded;
+            QuantisedPatches<Degree>::Encode(store, bounds).Decode(decoded);
+            context.Check(decoded.GetNumPatches() == 2 && MaxDifference(store, decoded, 2) == 0.f, "patches without extent decode exactly");
+        }
+    }
+
+    void TestEmptyStore(TestContext& context)
+    {
+        for (QuantisationBounds bounds : { QuantisationBounds::PerShape, QuantisationBounds::PerPatch })
+        {
+            auto const quantised = QuantisedPatches<Degree>::Encode(BezierPatchStore<Degree>{}, bounds);
+            context.Check(quantised.GetNumPatches() == 0 && quantised.GetErrorBound() == 0.f, "an empty store encodes to nothing");
+
+            BezierPatchStore<Degree> decoded;
+            decoded.Add(BezierTriangle<Degree>());
+            quantised.Decode(decoded);
+            context.Check(decoded.GetNumPatches() == 0, "decoding nothing empties the store");
+        }
+    }
+}
+
+void RunQuantisationTests(TestContext& context)
+{
+    constexpr size_t Width = Simd::FloatLanes::Width;
+
+    // Counts off the register width so the scalar tail runs, plus one past a whole cache line of patches
+    for (size_t numPatches : { size_t(1), Width - 1, Width, Width + 1, 2 * Width + 3, BezierPatchStore<Degree>::PatchGranularity + 1 })
+    {
+        TestRoundTrip(context, numPatches, QuantisationBounds::PerShape);
+        TestRoundTrip(context, numPatches, QuantisationBounds::PerPatch);
+    }
+
+    TestFlatPatches(context);
+    TestEmptyStore(context);
+}
\ No newline at end of file
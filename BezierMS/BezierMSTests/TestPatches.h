@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cmath>
+#include <random>
+
+#include "BezierMaths.h"
+
+namespace TestPatches
+{
+    // Degree N patch whose control points are the barycentric grid over corners pushed out onto the unit sphere, plus noise
+    // With the three positive axes as corners this is close to the TopRightFront octant
+    template<unsigned N>
+    BezierMaths::BezierTriangle<N> MakeSpherePatch(DirectX::SimpleMath::Vector3 const& cornerI, DirectX::SimpleMath::Vector3 const& cornerJ,
+                                                   DirectX::SimpleMath::Vector3 const& cornerK, float noise, std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> offset(-noise, noise);
+
+        BezierMaths::BezierTriangle<N> patch;
+        for (unsigned j = 0; j <= N; ++j)
+        {
+            for (unsigned k = 0; j + k <= N; ++k)
+            {
+                unsigned const i = N - j - k;
+                DirectX::SimpleMath::Vector3 point = (cornerI * float(i) + cornerJ * float(j) + cornerK * float(k)) / float(N);
+                point.Normalize();
+                patch.ControlPoints[BezierMaths::TriangularIndex<N>::To1D(j, k)] = point + DirectX::SimpleMath::Vector3(offset(rng), offset(rng), offset(rng));
+            }
+        }
+
+        return patch;
+    }
+
+    // Sphere patch over a small random spherical triangle, spread controls how far the corners are from a random centre direction
+    template<unsigned N>
+    BezierMaths::BezierTriangle<N> MakeRandomSpherePatch(float spread, float noise, std::mt19937& rng)
+    {
+        std::normal_distribution<float> gaussian;
+        auto const randomDirection = [&]()
+        {
+            DirectX::SimpleMath::Vector3 direction(gaussian(rng), gaussian(rng), gaussian(rng));
+            direction.Normalize();
+            return direction;
+        };
+
+        DirectX::SimpleMath::Vector3 const centre = randomDirection();
+        DirectX::SimpleMath::Vector3 corners[3];
+        for (auto& corner : corners)
+        {
+            corner = centre + randomDirection() * spread;
+        }
+
+        return MakeSpherePatch<N>(corners[0], corners[1], corners[2], noise, rng);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdio>
+#include <string>
+
+// Counts checks and prints the ones that fail, a test run passes when Failures stays zero
+struct TestContext
+{
+    void Check(bool condition, char const* description)
+    {
+        ++Checks;
+        if (!condition)
+        {
+            ++Failures;
+            std::printf("FAILED: %s\n", description);
+        }
+    }
+
+    size_t Checks = 0;
+    size_t Failures = 0;
+};
+
+void RunPatchStoreTests(TestContext& context);
+void RunQuantisationTests(TestContext& context);
+void RunCullingTests(TestContext& context);
+void RunAdaptiveTests(TestContext& context);
+void RunCullingBenchmark();
\ No newline at end of file